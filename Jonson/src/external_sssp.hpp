@@ -0,0 +1,281 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "graph.hpp"
+
+// Single source shortest paths for graphs that don't fit in memory.
+//
+// The graph lives on disk, split by source vertex into partitions of
+// partitionSize vertices: partition p holds the edges leaving
+// [p * partitionSize, (p + 1) * partitionSize) in part-<p>.bin, in any order.
+// graph.meta has the vertex count, partition size, edge count and the
+// weight range. Edges are native-endian 16 byte records, so 10^10 edges
+// take 160 GB on disk.
+//
+// In memory there are only the distances (8 bytes per vertex), the frontier
+// (1 bit per vertex) and the smallest frontier distance of every partition.
+// The frontier is processed in buckets of width delta (delta-stepping):
+// partitions without a frontier vertex in the current bucket are not read,
+// the others are read sequentially in blocks of blockBytes.
+
+struct partitionedEdge {
+    std::uint64_t to;
+    std::uint32_t fromOffset; // source - first vertex of the partition
+    std::int32_t  weight;
+};
+static_assert(sizeof(partitionedEdge) == 16);
+
+namespace external_detail {
+
+inline std::filesystem::path partitionPath(const std::filesystem::path& dir, std::size_t p) {
+    return dir / ("part-" + std::to_string(p) + ".bin");
+}
+
+inline std::filesystem::path metaPath(const std::filesystem::path& dir) {
+    return dir / "graph.meta";
+}
+
+} // namespace external_detail
+
+// Writes a partitioned graph edge by edge, nothing but a buffer per partition
+// is kept in memory. close() (or the destructor) flushes the buffers and
+// writes graph.meta, the graph can't be read before that.
+class partitionedGraphWriter {
+    std::filesystem::path dir_;
+    vertex_t V_;
+    vertex_t partitionSize_;
+    std::size_t bufferEdges_;
+    std::vector<std::vector<partitionedEdge>> buffers_;
+
+    std::uint64_t edges_ = 0;
+    weightedAdjListGraph::weight_type minWeight_ = 0, maxWeight_ = 0;
+    bool closed_ = false;
+
+    void flush(std::size_t p) {
+        auto& buf = buffers_[p];
+        if(buf.empty())
+            return;
+
+        std::ofstream out(external_detail::partitionPath(dir_, p), std::ios::binary | std::ios::app);
+        out.write(reinterpret_cast<const char*>(buf.data()), buf.size() * sizeof(partitionedEdge));
+        if(!out)
+            throw std::runtime_error("partitionedGraphWriter: can't write " + external_detail::partitionPath(dir_, p).string());
+        buf.clear();
+    }
+
+public:
+    using EdgeOrientation = weightedAdjListGraph::EdgeOrientation;
+
+    // Vertices are 0..V-1. Existing partitions in dir are overwritten
+    partitionedGraphWriter(const std::filesystem::path& dir, vertex_t V, vertex_t partitionSize, std::size_t bufferEdges = 1 << 12)
+        : dir_(dir), V_(V), partitionSize_(partitionSize), bufferEdges_(std::max<std::size_t>(bufferEdges, 1)) {
+        if(partitionSize == 0 || partitionSize > UINT32_MAX)
+            throw std::invalid_argument("partitionedGraphWriter: partition size must be in [1, 2^32)");
+
+        std::filesystem::create_directories(dir_);
+        std::filesystem::remove(external_detail::metaPath(dir_));
+        buffers_.resize((V_ + partitionSize_ - 1) / partitionSize_);
+        for(std::size_t p = 0; p < buffers_.size(); ++p) {
+            std::ofstream out(external_detail::partitionPath(dir_, p), std::ios::binary | std::ios::trunc);
+            if(!out)
+                throw std::runtime_error("partitionedGraphWriter: can't create " + external_detail::partitionPath(dir_, p).string());
+        }
+    }
+
+    partitionedGraphWriter(const partitionedGraphWriter&) = delete;
+    partitionedGraphWriter& operator=(const partitionedGraphWriter&) = delete;
+
+    ~partitionedGraphWriter() {
+        try {
+            close();
+        } catch(...) {
+        }
+    }
+
+    void addEdge(vertex_t src, weightedAdjListGraph::edge_type adj_v, EdgeOrientation orientation = EdgeOrientation::NotOriented) {
+        assert(!closed_);
+        assert(src < V_ && adj_v.first < V_);
+
+        std::size_t p = src / partitionSize_;
+        buffers_[p].push_back({adj_v.first, static_cast<std::uint32_t>(src - p * partitionSize_), adj_v.second});
+        minWeight_ = edges_ == 0 ? adj_v.second : std::min(minWeight_, adj_v.second);
+        maxWeight_ = edges_ == 0 ? adj_v.second : std::max(maxWeight_, adj_v.second);
+        ++edges_;
+        if(buffers_[p].size() >= bufferEdges_)
+            flush(p);
+
+        if(orientation == EdgeOrientation::NotOriented)
+            addEdge(adj_v.first, {src, adj_v.second}, EdgeOrientation::Oriented);
+    }
+
+    void close() {
+        if(closed_)
+            return;
+        closed_ = true;
+
+        for(std::size_t p = 0; p < buffers_.size(); ++p)
+            flush(p);
+
+        std::ofstream meta(external_detail::metaPath(dir_));
+        meta << V_ << ' ' << partitionSize_ << ' ' << edges_ << ' ' << minWeight_ << ' ' << maxWeight_ << '\n';
+        if(!meta)
+            throw std::runtime_error("partitionedGraphWriter: can't write " + external_detail::metaPath(dir_).string());
+    }
+};
+
+// Vertices of g have to be 0..g.V()-1, as for dijkstra
+inline void writePartitionedGraph(const weightedAdjListGraph& g, const std::filesystem::path& dir, vertex_t partitionSize) {
+    partitionedGraphWriter out(dir, g.V(), partitionSize);
+    for(vertex_t u = 0; u < g.V(); ++u)
+        for(auto edge : g.getAdjList(u))
+            out.addEdge(u, edge, weightedAdjListGraph::EdgeOrientation::Oriented);
+    out.close();
+}
+
+// Read side of a partitioned graph
+class partitionedGraph {
+    std::filesystem::path dir_;
+    vertex_t V_ = 0;
+    vertex_t partitionSize_ = 1;
+    std::uint64_t edges_ = 0;
+    weightedAdjListGraph::weight_type minWeight_ = 0, maxWeight_ = 0;
+
+    partitionedGraph() = default;
+
+public:
+    static std::optional<partitionedGraph> open(const std::filesystem::path& dir) {
+        std::ifstream meta(external_detail::metaPath(dir));
+        partitionedGraph g;
+        if(!(meta >> g.V_ >> g.partitionSize_ >> g.edges_ >> g.minWeight_ >> g.maxWeight_) || g.partitionSize_ == 0)
+            return std::nullopt;
+
+        g.dir_ = dir;
+        return g;
+    }
+
+    vertex_t V() const { return V_; }
+    std::uint64_t E() const { return edges_; }
+    vertex_t partitionSize() const { return partitionSize_; }
+    std::size_t partitions() const { return (V_ + partitionSize_ - 1) / partitionSize_; }
+    vertex_t partitionBegin(std::size_t p) const { return p * partitionSize_; }
+    vertex_t partitionEnd(std::size_t p) const { return std::min(V_, (p + 1) * partitionSize_); }
+    weightedAdjListGraph::weight_type minWeight() const { return minWeight_; }
+    weightedAdjListGraph::weight_type maxWeight() const { return maxWeight_; }
+
+    // Reads partition p front to back through buf, calls f(edge) for every edge,
+    // returns the number of bytes read
+    template <typename F>
+    std::uint64_t forEachEdge(std::size_t p, std::vector<partitionedEdge>& buf, F&& f) const {
+        std::ifstream in(external_detail::partitionPath(dir_, p), std::ios::binary);
+        if(!in)
+            throw std::runtime_error("partitionedGraph: can't open " + external_detail::partitionPath(dir_, p).string());
+
+        std::uint64_t bytes = 0;
+        while(in) {
+            in.read(reinterpret_cast<char*>(buf.data()), buf.size() * sizeof(partitionedEdge));
+            std::size_t n = in.gcount() / sizeof(partitionedEdge);
+            bytes += in.gcount();
+            for(std::size_t i = 0; i < n; ++i)
+                f(buf[i]);
+        }
+        if(in.bad())
+            throw std::runtime_error("partitionedGraph: can't read " + external_detail::partitionPath(dir_, p).string());
+        return bytes;
+    }
+};
+
+struct externalSsspOptions {
+    distance_t  delta = 0;           // bucket width, 0 - the largest edge weight
+    std::size_t blockBytes = 1 << 24; // size of one sequential read
+};
+
+struct externalSsspStats {
+    std::uint64_t buckets = 0;
+    std::uint64_t partitionScans = 0;
+    std::uint64_t bytesRead = 0;
+};
+
+// Same result as dijkstra(src, g) for the graph written to dir: nullopt if
+// there is no graph, src isn't a vertex or a weight is negative.
+//
+// A small delta gives few rescans of a vertex but many buckets, and every
+// bucket reads the partitions of its frontier at least once; delta = 1 is
+// Dial's algorithm. With delta >= the largest weight the frontier spans at
+// most two buckets.
+inline std::optional<dist_vect_t> externalSssp(vertex_t src, const std::filesystem::path& dir,
+                                               externalSsspOptions opts = {}, externalSsspStats* stats = nullptr) {
+    auto g = partitionedGraph::open(dir);
+    if(!g || src >= g->V() || g->minWeight() < 0)
+        return std::nullopt;
+
+    const distance_t delta = opts.delta > 0 ? opts.delta : std::max<distance_t>(g->maxWeight(), 1);
+    const std::size_t P = g->partitions();
+
+    dist_vect_t dist(g->V(), InfDist);
+    std::vector<bool> dirty(g->V());           // frontier: distance improved since the last scan
+    std::vector<distance_t> partMin(P, InfDist); // smallest frontier distance per partition
+    std::vector<bool> active(std::min(g->partitionSize(), g->V())); // scanned vertices of a partition
+    std::vector<partitionedEdge> buf(std::max<std::size_t>(opts.blockBytes / sizeof(partitionedEdge), 1));
+    externalSsspStats st;
+
+    auto relax = [&](vertex_t v, distance_t d) {
+        if(d < dist[v]) {
+            dist[v] = d;
+            dirty[v] = true;
+            std::size_t p = v / g->partitionSize();
+            partMin[p] = std::min(partMin[p], d);
+        }
+    };
+
+    relax(src, 0);
+    while(true) {
+        distance_t m = *std::min_element(partMin.begin(), partMin.end());
+        if(m == InfDist)
+            break;
+
+        ++st.buckets;
+        const distance_t bucketEnd = m / delta * delta + std::min(delta, InfDist - m / delta * delta);
+
+        // Distances in the bucket can go on improving while it's processed:
+        // sweep the partitions until none has a frontier vertex in it
+        bool progress = true;
+        while(progress) {
+            progress = false;
+            for(std::size_t p = 0; p < P; ++p) {
+                if(partMin[p] >= bucketEnd)
+                    continue;
+                progress = true;
+
+                // vertices scanned now leave the frontier, the rest stay
+                const vertex_t lo = g->partitionBegin(p), hi = g->partitionEnd(p);
+                partMin[p] = InfDist;
+                for(vertex_t v = lo; v < hi; ++v) {
+                    active[v - lo] = dirty[v] && dist[v] < bucketEnd;
+                    if(active[v - lo])
+                        dirty[v] = false;
+                    else if(dirty[v])
+                        partMin[p] = std::min(partMin[p], dist[v]);
+                }
+
+                ++st.partitionScans;
+                st.bytesRead += g->forEachEdge(p, buf, [&](const partitionedEdge& e) {
+                    if(active[e.fromOffset])
+                        relax(e.to, dist[lo + e.fromOffset] + e.weight);
+                });
+            }
+        }
+    }
+
+    if(stats)
+        *stats = st;
+    return dist;
+}
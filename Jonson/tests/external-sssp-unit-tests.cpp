@@ -0,0 +1,128 @@
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <random>
+
+#include "dijkstra.hpp"
+#include "external_sssp.hpp"
+
+namespace fs = std::filesystem;
+
+const auto Oriented = weightedAdjListGraph::EdgeOrientation::Oriented;
+
+// Fresh directory for the partitions of one test
+class ExternalSssp : public ::testing::Test {
+protected:
+    fs::path dir;
+
+    void SetUp() override {
+        dir = fs::temp_directory_path() /
+              ("external-sssp-" + std::string(::testing::UnitTest::GetInstance()->current_test_info()->name()));
+        fs::remove_all(dir);
+    }
+
+    void TearDown() override { fs::remove_all(dir); }
+};
+
+TEST_F(ExternalSssp, Basic) {
+    weightedAdjListGraph graph;
+    graph.addVertices({0, 1, 2, 3});
+    graph.addEdge(0, {1, 1});
+    graph.addEdge(0, {2, 4});
+    graph.addEdge(1, {2, 2});
+    graph.addEdge(1, {3, 6});
+    graph.addEdge(2, {3, 1});
+    writePartitionedGraph(graph, dir, 2);
+
+    auto distances = externalSssp(0, dir);
+    ASSERT_TRUE(distances);
+    EXPECT_EQ(*distances, (dist_vect_t{0, 1, 3, 4}));
+}
+
+TEST_F(ExternalSssp, Disconnected) {
+    partitionedGraphWriter out(dir, 4, 3);
+    out.addEdge(0, {1, 5});
+    out.close();
+
+    auto distances = externalSssp(1, dir);
+    ASSERT_TRUE(distances);
+    EXPECT_EQ(*distances, (dist_vect_t{5, 0, InfDist, InfDist}));
+}
+
+TEST_F(ExternalSssp, BadInput) {
+    EXPECT_FALSE(externalSssp(0, dir)); // no graph
+
+    {
+        partitionedGraphWriter out(dir, 3, 2);
+        out.addEdge(0, {1, 2}, Oriented);
+        EXPECT_FALSE(externalSssp(0, dir)); // not closed yet
+    }
+    EXPECT_TRUE(externalSssp(0, dir));
+    EXPECT_FALSE(externalSssp(3, dir)); // no such vertex
+
+    partitionedGraphWriter out(dir, 3, 2);
+    out.addEdge(0, {1, 2}, Oriented);
+    out.addEdge(1, {2, -1}, Oriented);
+    out.close();
+    EXPECT_FALSE(externalSssp(0, dir)); // negative weight
+}
+
+TEST_F(ExternalSssp, PartitionLargerThanGraph) {
+    // one partition, per-partition state is sized by the vertex count
+    partitionedGraphWriter out(dir, 10, vertex_t{1} << 31);
+    for (vertex_t u = 0; u + 1 < 10; ++u)
+        out.addEdge(u, {u + 1, 2}, Oriented);
+    out.close();
+
+    auto distances = externalSssp(0, dir);
+    ASSERT_TRUE(distances);
+    EXPECT_EQ(*distances, (dist_vect_t{0, 2, 4, 6, 8, 10, 12, 14, 16, 18}));
+}
+
+TEST_F(ExternalSssp, SkipsPartitionsOffTheFrontier) {
+    // path 0 -> 1 -> ... -> 99, one vertex per partition: every bucket has a
+    // single frontier vertex, so every partition is read exactly once
+    const vertex_t V = 100;
+    partitionedGraphWriter out(dir, V, 1);
+    for (vertex_t u = 0; u + 1 < V; ++u)
+        out.addEdge(u, {u + 1, 3}, Oriented);
+    out.close();
+
+    externalSsspStats stats;
+    auto distances = externalSssp(0, dir, {}, &stats);
+    ASSERT_TRUE(distances);
+    for (vertex_t v = 0; v < V; ++v)
+        EXPECT_EQ((*distances)[v], 3 * static_cast<distance_t>(v));
+
+    EXPECT_EQ(stats.buckets, V);
+    EXPECT_EQ(stats.partitionScans, V);
+    EXPECT_EQ(stats.bytesRead, (V - 1) * sizeof(partitionedEdge));
+}
+
+TEST_F(ExternalSssp, RandomGraphsMatchDijkstra) {
+    std::mt19937_64 gen(2025);
+
+    for (int iter = 0; iter < 30; ++iter) {
+        const vertex_t V = 1 + gen() % 200;
+        const std::size_t E = gen() % (V * 8);
+        const int maxWeight = iter % 3 == 0 ? 1 : 1 + gen() % 1000;
+
+        weightedAdjListGraph graph;
+        for (vertex_t v = 0; v < V; ++v)
+            graph.addVertex(v);
+        for (std::size_t i = 0; i < E; ++i)
+            graph.addEdge(gen() % V, {gen() % V, gen() % (maxWeight + 1)}, Oriented);
+        writePartitionedGraph(graph, dir, 1 + gen() % V);
+
+        const vertex_t src = gen() % V;
+        auto expected = dijkstra(src, graph);
+        ASSERT_TRUE(expected);
+
+        // tiny blocks to cross block boundaries, deltas from Dial's to one bucket
+        for (distance_t delta : {distance_t{0}, distance_t{1}, distance_t{7}, InfDist / 2}) {
+            auto distances = externalSssp(src, dir, {delta, 3 * sizeof(partitionedEdge)});
+            ASSERT_TRUE(distances);
+            EXPECT_EQ(*distances, *expected) << "iteration " << iter << ", delta " << delta;
+        }
+    }
+}
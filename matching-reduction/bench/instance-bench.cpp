@@ -0,0 +1,75 @@
+#include <benchmark/benchmark.h>
+#include <map>
+#include <memory>
+#include <tuple>
+
+#include "bipartite_graph.hpp"
+#include "instance_generator.hpp"
+
+// Matching and cover timed separately on generated instances up to the input
+// limits of the judge (n1, n2, m <= 200000). Arguments are the instance kind
+// (0 - random, 1 - power-law, 2 - worst case for Kuhn) and the engine
+// (0 - Hopcroft-Karp, 1 - Kuhn, 2 - Pothen-Fan, 3 - Dinic).
+// The matching starts from Karp-Sipser (--init ks), the fastest setup. The
+// main program defaults to Kuhn without an initial matching (--init none), so
+// its answers match the original ones; BM_KuhnNoInit times that default and
+// shows its quadratic worst case.
+
+namespace {
+
+constexpr int MaxSize = 200000;
+
+BipartiteGraph& instance(int kind, int n, int m) {
+    static std::map<std::tuple<int, int, int>, std::unique_ptr<BipartiteGraph>> cache;
+    auto& g = cache[{kind, n, m}];
+    if (!g) {
+        Instance inst = generateInstance(static_cast<InstanceKind>(kind), n, n, m, 2024);
+        g = std::make_unique<BipartiteGraph>(inst.n1, inst.n2, inst.edges);
+    }
+    return *g;
+}
+
+int runEngine(BipartiteGraph& g, int engine) {
+    switch (engine) {
+    case 0:  return g.maxMatchingHopcroftKarp();
+    case 1:  return g.maxMatchingKuhn();
+    case 2:  return g.maxMatchingPothenFan();
+    default: return g.maxMatchingDinic();
+    }
+}
+
+void BM_Matching(benchmark::State& state) {
+    BipartiteGraph& g = instance(state.range(0), MaxSize, MaxSize);
+    int size = 0;
+    for (auto _ : state) {
+        size = g.initialMatching(BipartiteGraph::InitStrategy::KarpSipser);
+        size = runEngine(g, state.range(1));
+    }
+    state.counters["matching"] = size;
+}
+
+void BM_Cover(benchmark::State& state) {
+    BipartiteGraph& g = instance(state.range(0), MaxSize, MaxSize);
+    g.initialMatching(BipartiteGraph::InitStrategy::KarpSipser);
+    g.maxMatchingHopcroftKarp();
+    for (auto _ : state) {
+        g.buildCover();
+    }
+}
+
+void BM_KuhnNoInit(benchmark::State& state) {
+    int n = state.range(1);
+    BipartiteGraph& g = instance(state.range(0), n, n);
+    int size = 0;
+    for (auto _ : state) {
+        g.resetMatching();
+        size = g.maxMatchingKuhn();
+    }
+    state.counters["matching"] = size;
+}
+
+} // namespace
+
+BENCHMARK(BM_Matching)->ArgsProduct({{0, 1, 2}, {0, 1, 2, 3}})->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(BM_Cover)->DenseRange(0, 2)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(BM_KuhnNoInit)->ArgsProduct({{0, 2}, {10000, 20000, 40000}})->Unit(benchmark::kMillisecond)->UseRealTime();
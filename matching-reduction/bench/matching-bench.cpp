@@ -0,0 +1,65 @@
+#include <benchmark/benchmark.h>
+#include <map>
+#include <memory>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "bipartite_graph.hpp"
+
+// Maximum matching on random sparse instances (n + n vertices, degree 8):
+// serial Hopcroft-Karp and Dinic vs Pothen-Fan on a growing number of threads
+
+namespace {
+
+constexpr int Degree = 8;
+
+// one graph per size, shared by all benchmarks
+BipartiteGraph& instance(int n) {
+    static std::map<int, std::unique_ptr<BipartiteGraph>> cache;
+    auto& g = cache[n];
+    if (!g) {
+        std::mt19937 gen(n);
+        std::vector<std::pair<int, int>> edges(static_cast<std::size_t>(n) * Degree);
+        for (auto& [u, v] : edges) {
+            u = gen() % n + 1;
+            v = gen() % n + 1;
+        }
+        g = std::make_unique<BipartiteGraph>(n, n, edges);
+    }
+    return *g;
+}
+
+template<typename Run>
+void matching(benchmark::State& state, Run run) {
+    BipartiteGraph& g = instance(state.range(0));
+    int size = 0;
+    for (auto _ : state) {
+        state.PauseTiming();
+        g.resetMatching();
+        state.ResumeTiming();
+        size = run(g);
+    }
+    state.counters["matching"] = size;
+    state.counters["edges/s"] = benchmark::Counter(static_cast<double>(g.edgeCount()) * state.iterations(),
+                                                   benchmark::Counter::kIsRate);
+}
+
+void BM_HopcroftKarp(benchmark::State& state) {
+    matching(state, [](BipartiteGraph& g) { return g.maxMatchingHopcroftKarp(); });
+}
+
+void BM_Dinic(benchmark::State& state) {
+    matching(state, [](BipartiteGraph& g) { return g.maxMatchingDinic(); });
+}
+
+void BM_PothenFan(benchmark::State& state) {
+    unsigned threads = state.range(1);
+    matching(state, [threads](BipartiteGraph& g) { return g.maxMatchingPothenFan(threads); });
+}
+
+} // namespace
+
+BENCHMARK(BM_HopcroftKarp)->Arg(1 << 16)->Arg(1 << 20)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(BM_Dinic)->Arg(1 << 16)->Arg(1 << 20)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(BM_PothenFan)->ArgsProduct({{1 << 16, 1 << 20}, {1, 2, 4, 8}})->Unit(benchmark::kMillisecond)->UseRealTime();
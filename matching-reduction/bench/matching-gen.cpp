@@ -0,0 +1,51 @@
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+
+#include "bipartite_graph.hpp"
+#include "instance_generator.hpp"
+
+// Writes an input for matching-reduction:
+//   matching-gen random|powerlaw|kuhn n1 n2 m q seed > input
+// Queries are random, type 1 never removes more vertices than the cover has.
+
+int main(int argc, char* argv[]) {
+    if (argc != 7) {
+        std::fprintf(stderr, "usage: %s random|powerlaw|kuhn n1 n2 m q seed\n", argv[0]);
+        return 1;
+    }
+    InstanceKind kind;
+    if (std::strcmp(argv[1], "random") == 0) {
+        kind = InstanceKind::Random;
+    } else if (std::strcmp(argv[1], "powerlaw") == 0) {
+        kind = InstanceKind::PowerLaw;
+    } else if (std::strcmp(argv[1], "kuhn") == 0) {
+        kind = InstanceKind::KuhnWorstCase;
+    } else {
+        std::fprintf(stderr, "unknown instance kind %s\n", argv[1]);
+        return 1;
+    }
+    int n1 = std::atoi(argv[2]);
+    int n2 = std::atoi(argv[3]);
+    int m = std::atoi(argv[4]);
+    int q = std::atoi(argv[5]);
+    std::uint64_t seed = std::strtoull(argv[6], nullptr, 10);
+
+    Instance inst = generateInstance(kind, n1, n2, m, seed);
+    BipartiteGraph g(inst.n1, inst.n2, inst.edges);
+    int cover = g.maxMatchingHopcroftKarp();
+
+    std::printf("%d %d %zu %d\n", inst.n1, inst.n2, inst.edges.size(), q);
+    for (auto [u, v] : inst.edges) {
+        std::printf("%d %d\n", u, v);
+    }
+    std::mt19937_64 gen(seed + 1);
+    for (int i = 0; i < q; ++i) {
+        bool remove = cover > 0 && gen() % 2 == 0;
+        cover -= remove;
+        std::printf("%d\n", remove ? 1 : 2);
+    }
+    return 0;
+}
@@ -0,0 +1,66 @@
+#include <benchmark/benchmark.h>
+#include <map>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "weighted_matching.hpp"
+
+// Maximum weight matching with edge numbers as weights, like the main program:
+// Hungarian on dense instances, auction on dense and on large sparse ones
+
+namespace {
+
+constexpr int SparseDegree = 8;
+
+// one edge list per (n, edge count), shared by all benchmarks
+const std::vector<WeightedEdge>& instance(int n, long long m) {
+    static std::map<std::pair<int, long long>, std::vector<WeightedEdge>> cache;
+    auto& edges = cache[{n, m}];
+    if (edges.empty()) {
+        std::mt19937 gen(n);
+        edges.resize(m);
+        for (std::size_t k = 0; k < edges.size(); ++k) {
+            edges[k] = {static_cast<int>(gen() % n + 1), static_cast<int>(gen() % n + 1), static_cast<long long>(k + 1)};
+        }
+    }
+    return edges;
+}
+
+long long denseEdges(int n) {
+    return static_cast<long long>(n) * n / 4;
+}
+
+template<typename Run>
+void weighted(benchmark::State& state, const std::vector<WeightedEdge>& edges, Run run) {
+    long long weight = 0;
+    for (auto _ : state) {
+        weight = run(edges).weight;
+    }
+    state.counters["weight"] = static_cast<double>(weight);
+}
+
+void BM_Hungarian(benchmark::State& state) {
+    int n = state.range(0);
+    weighted(state, instance(n, denseEdges(n)), [n](const auto& edges) { return hungarianMaxWeight(n, n, edges); });
+}
+
+void BM_AuctionDense(benchmark::State& state) {
+    int n = state.range(0);
+    unsigned threads = state.range(1);
+    weighted(state, instance(n, denseEdges(n)),
+             [n, threads](const auto& edges) { return auctionMaxWeight(n, n, edges, threads); });
+}
+
+void BM_AuctionSparse(benchmark::State& state) {
+    int n = state.range(0);
+    unsigned threads = state.range(1);
+    weighted(state, instance(n, static_cast<long long>(n) * SparseDegree),
+             [n, threads](const auto& edges) { return auctionMaxWeight(n, n, edges, threads); });
+}
+
+} // namespace
+
+BENCHMARK(BM_Hungarian)->Arg(256)->Arg(1024)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(BM_AuctionDense)->ArgsProduct({{256, 1024}, {1, 4}})->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(BM_AuctionSparse)->ArgsProduct({{1 << 16, 1 << 18}, {1, 2, 4, 8}})->Unit(benchmark::kMillisecond)->UseRealTime();
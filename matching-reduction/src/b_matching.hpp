@@ -0,0 +1,69 @@
+#pragma once
+
+#include <stdexcept>
+#include <vector>
+
+#include "bipartite_graph.hpp"
+#include "max_flow.hpp"
+
+// Maximum b-matching: left vertex u takes part in at most capL[u] matched
+// edges, right vertex v in at most capR[v], an edge is used at most edgeCap
+// times (MaxFlow::Inf - no limit). Capacities are indexed by vertex, [0] is unused.
+// The minimum cut is a minimum weight cover of the edges, with weights capL,
+// capR and edgeCap; with all capacities 1 and edgeCap = Inf it is the Konig
+// vertex cover.
+struct BMatching {
+    long long size = 0;
+    std::vector<long long> edgeFlow;                        // by edge number, [0] is unused
+    std::vector<char> cutL, cutR;                           // vertices in the minimum cut
+    std::vector<BipartiteGraph::edge_number_t> cutEdges;    // edges in the minimum cut
+};
+
+inline BMatching maxBMatching(const BipartiteGraph& g, const std::vector<long long>& capL,
+                              const std::vector<long long>& capR, long long edgeCap = 1) {
+    const int n1 = g.leftSize(), n2 = g.rightSize();
+    if (static_cast<int>(capL.size()) != n1 + 1 || static_cast<int>(capR.size()) != n2 + 1) {
+        throw std::invalid_argument("maxBMatching: capacities don't match the graph");
+    }
+
+    // same network as BipartiteGraph::maxMatchingDinic
+    const int source = 0, sink = n1 + n2 + 1;
+    MaxFlow net(n1 + n2 + 2);
+    for (int u = 1; u <= n1; ++u) {
+        net.addEdge(source, u, capL[u]);
+    }
+    for (int v = 1; v <= n2; ++v) {
+        net.addEdge(n1 + v, sink, capR[v]);
+    }
+    std::vector<int> edgeId(g.edgeCount() + 1);
+    for (int u = 1; u <= n1; ++u) {
+        for (const auto& a : g.adj(u)) {
+            edgeId[a.idx] = net.addEdge(u, n1 + a.v, edgeCap);
+        }
+    }
+
+    BMatching res;
+    res.size = net.maxFlow(source, sink);
+    res.edgeFlow.assign(edgeId.size(), 0);
+    for (std::size_t e = 1; e < edgeId.size(); ++e) {
+        res.edgeFlow[e] = net.flow(edgeId[e]);
+    }
+
+    // source -> u is cut iff u is off the source side, v -> sink iff v is on it
+    res.cutL.assign(n1 + 1, 0);
+    res.cutR.assign(n2 + 1, 0);
+    for (int u = 1; u <= n1; ++u) {
+        res.cutL[u] = !net.onSourceSide(u);
+    }
+    for (int v = 1; v <= n2; ++v) {
+        res.cutR[v] = net.onSourceSide(n1 + v);
+    }
+    for (int u = 1; u <= n1; ++u) {
+        for (const auto& a : g.adj(u)) {
+            if (net.onSourceSide(u) && !net.onSourceSide(n1 + a.v)) {
+                res.cutEdges.push_back(a.idx);
+            }
+        }
+    }
+    return res;
+}
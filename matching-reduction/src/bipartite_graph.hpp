@@ -0,0 +1,622 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <barrier>
+#include <climits>
+#include <cstddef>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "max_flow.hpp"
+
+// Bipartite graph with left vertices 1..n1 and right vertices 1..n2,
+// maximum matching and Konig minimum vertex cover.
+// Adjacency is kept in CSR form (one array of arcs, offsets per left vertex),
+// all searches are iterative, so deep augmenting paths don't grow the call stack.
+class BipartiteGraph {
+public:
+    using vertex_t      = int;  // 0 means "no vertex"
+    using edge_number_t = int;  // edges are numbered from 1 in input order
+
+    // Linear-time heuristics for the starting matching
+    enum class InitStrategy {
+        None,       // empty matching
+        Greedy,     // every left vertex takes its first free neighbour
+        DegreeOne,  // left vertices of degree 1 first, then Greedy
+        KarpSipser, // vertices with one free neighbour first, otherwise min degree
+    };
+
+    struct Arc {
+        vertex_t v;
+        edge_number_t idx;
+    };
+
+private:
+    int n1_ = 0;
+    int n2_ = 0;
+
+    std::vector<std::size_t> offsets_; // arcs of u are [offsets_[u], offsets_[u + 1])
+    std::vector<Arc> arcs_;
+
+    std::vector<vertex_t> matchL_;      // matches of Left  nodes
+    std::vector<vertex_t> matchR_;      // matches of Right nodes
+    std::vector<std::size_t> matchArc_; // arc of the matching edge of left node
+
+    // visited marks: u is visited iff seenL_[u] == stamp_, cleared by ++stamp_
+    std::vector<unsigned> seenL_;
+    unsigned stamp_ = 0;
+
+    std::vector<int> distL_;           // Hopcroft-Karp BFS layer
+    std::vector<std::size_t> arcPos_;  // next arc to try
+    std::vector<vertex_t> stack_;
+
+    // Konig cover: reachable by alternating paths from free left vertices
+    std::vector<char> visL_, visR_;
+
+    static constexpr int Inf = INT_MAX;
+
+    void match(vertex_t u, std::size_t arc) {
+        matchL_[u] = arcs_[arc].v;
+        matchR_[arcs_[arc].v] = u;
+        matchArc_[u] = arc;
+    }
+
+    void nextStamp() {
+        if (++stamp_ == 0) { // wrapped around, old marks could look fresh
+            std::fill(seenL_.begin(), seenL_.end(), 0);
+            stamp_ = 1;
+        }
+    }
+
+    bool augmentKuhn(vertex_t root);
+    bool bfsLayers();
+    bool augmentLayered(vertex_t root);
+
+    // first arc of u to a free right vertex, offsets_[u + 1] if there is none
+    std::size_t freeArc(vertex_t u) const {
+        std::size_t a = offsets_[u];
+        while (a < offsets_[u + 1] && matchR_[arcs_[a].v] != 0) {
+            ++a;
+        }
+        return a;
+    }
+    int greedy(bool degreeOneFirst);
+    int karpSipser();
+
+    // Pothen-Fan state, right vertex v is claimed in the current phase iff claimedR_[v] == phase
+    std::unique_ptr<std::atomic<unsigned>[]> claimedR_;
+    std::vector<std::size_t> lookahead_; // next arc of u to check for a free right vertex
+    std::vector<std::size_t> via_;       // arc by which the search path leaves u
+    bool claim(vertex_t v, unsigned phase) {
+        return claimedR_[v].load(std::memory_order_relaxed) != phase &&
+               claimedR_[v].exchange(phase, std::memory_order_relaxed) != phase;
+    }
+    bool augmentPothenFan(vertex_t root, unsigned phase, std::vector<vertex_t>& stack);
+
+public:
+    // edges[i] = {u, v} gets number i + 1, throws std::out_of_range on bad endpoints
+    BipartiteGraph(int n1, int n2, const std::vector<std::pair<vertex_t, vertex_t>>& edges);
+
+    int leftSize()  const { return n1_; }
+    int rightSize() const { return n2_; }
+    std::size_t edgeCount() const { return arcs_.size(); }
+
+    // arcs of left vertex u in input order
+    std::span<const Arc> adj(vertex_t u) const {
+        return {arcs_.data() + offsets_[u], arcs_.data() + offsets_[u + 1]};
+    }
+
+    // Replaces the matching with the one found by strategy, returns its size
+    int initialMatching(InitStrategy strategy);
+    void resetMatching() { initialMatching(InitStrategy::None); }
+    int matchingSize() const;
+
+    // Augment the current matching to a maximum one, return its size
+    // Kuhn's augmenting paths, O(V*E)
+    int maxMatchingKuhn();
+    // Hopcroft-Karp, O(E*sqrt(V))
+    int maxMatchingHopcroftKarp();
+    // Pothen-Fan with lookahead and fairness on threads (0 - hardware concurrency).
+    // Searches from all free left vertices run concurrently and claim right
+    // vertices atomically, so the augmenting paths of one phase are disjoint.
+    int maxMatchingPothenFan(unsigned threads = 0);
+    // Dinic on the unit network source -> left -> right -> sink, O(E*sqrt(V))
+    int maxMatchingDinic();
+
+    vertex_t matchL(vertex_t u) const { return matchL_[u]; }
+    vertex_t matchR(vertex_t v) const { return matchR_[v]; }
+    // number of the edge matching left vertex u, 0 if u is free. Of parallel
+    // edges the first in input order, whichever copy the engine matched
+    edge_number_t matchedEdge(vertex_t u) const {
+        if (matchL_[u] == 0) {
+            return 0;
+        }
+        std::size_t a = offsets_[u]; // stops at matchArc_[u] at the latest
+        while (arcs_[a].v != matchL_[u]) {
+            ++a;
+        }
+        return arcs_[a].idx;
+    }
+
+    // Builds Konig minimum vertex cover of the current (maximum) matching
+    void buildCover();
+    bool inCoverL(vertex_t u) const { return !visL_[u]; }
+    bool inCoverR(vertex_t v) const { return visR_[v]; }
+};
+
+inline BipartiteGraph::BipartiteGraph(int n1, int n2, const std::vector<std::pair<vertex_t, vertex_t>>& edges)
+    : n1_(n1), n2_(n2), offsets_(n1 + 2, 0), arcs_(edges.size()),
+      matchL_(n1 + 1, 0), matchR_(n2 + 1, 0), matchArc_(n1 + 1, 0), seenL_(n1 + 1, 0),
+      distL_(n1 + 1, 0), arcPos_(n1 + 1, 0), visL_(n1 + 1, 0), visR_(n2 + 1, 0) {
+    for (auto [u, v] : edges) {
+        if (u < 1 || u > n1 || v < 1 || v > n2) {
+            throw std::out_of_range("BipartiteGraph: edge endpoint out of range");
+        }
+        offsets_[u + 1]++;
+    }
+    for (int u = 1; u <= n1; ++u) {
+        offsets_[u + 1] += offsets_[u];
+    }
+
+    // counting sort by u keeps input order within each list
+    std::vector<std::size_t> pos(offsets_.begin(), offsets_.end() - 1);
+    for (std::size_t i = 0; i < edges.size(); ++i) {
+        auto [u, v] = edges[i];
+        arcs_[pos[u]++] = Arc{v, static_cast<edge_number_t>(i + 1)};
+    }
+}
+
+// Iterative dfs: the stack holds the current alternating path,
+// arcPos_[u] - 1 is the arc by which the path leaves u
+inline bool BipartiteGraph::augmentKuhn(vertex_t root) {
+    stack_.clear();
+    stack_.push_back(root);
+    seenL_[root] = stamp_;
+    arcPos_[root] = offsets_[root];
+
+    while (!stack_.empty()) {
+        vertex_t u = stack_.back();
+        if (arcPos_[u] == offsets_[u + 1]) {
+            stack_.pop_back();
+            continue;
+        }
+        vertex_t w = matchR_[arcs_[arcPos_[u]++].v];
+        if (w == 0) {
+            for (vertex_t x : stack_) {
+                match(x, arcPos_[x] - 1);
+            }
+            return true;
+        }
+        if (seenL_[w] != stamp_) {
+            seenL_[w] = stamp_;
+            arcPos_[w] = offsets_[w];
+            stack_.push_back(w);
+        }
+    }
+    return false;
+}
+
+inline int BipartiteGraph::maxMatchingKuhn() {
+    int matching = matchingSize();
+    for (vertex_t u = 1; u <= n1_; ++u) {
+        if (matchL_[u] != 0) {
+            continue;
+        }
+        nextStamp();
+        if (augmentKuhn(u)) {
+            matching++;
+        }
+    }
+    return matching;
+}
+
+// Layers left vertices by distance from free ones,
+// returns false if no augmenting path is left
+inline bool BipartiteGraph::bfsLayers() {
+    std::size_t head = 0;
+    stack_.clear(); // used as the queue
+    for (vertex_t u = 1; u <= n1_; ++u) {
+        if (matchL_[u] == 0) {
+            distL_[u] = 0;
+            stack_.push_back(u);
+        } else {
+            distL_[u] = Inf;
+        }
+    }
+
+    bool found = false;
+    while (head < stack_.size()) {
+        vertex_t u = stack_[head++];
+        for (const Arc& a : adj(u)) {
+            vertex_t w = matchR_[a.v];
+            if (w == 0) {
+                found = true; // free right vertex ends a shortest path
+            } else if (distL_[w] == Inf) {
+                distL_[w] = distL_[u] + 1;
+                stack_.push_back(w);
+            }
+        }
+    }
+    return found;
+}
+
+// Iterative layered dfs: arcPos_[u] is the current arc of u for the whole phase,
+// a vertex without a way forward is cut off by setting its layer to Inf
+inline bool BipartiteGraph::augmentLayered(vertex_t root) {
+    stack_.clear();
+    stack_.push_back(root);
+
+    while (!stack_.empty()) {
+        vertex_t u = stack_.back();
+        if (arcPos_[u] == offsets_[u + 1]) {
+            distL_[u] = Inf;
+            stack_.pop_back();
+            continue;
+        }
+        vertex_t w = matchR_[arcs_[arcPos_[u]].v];
+        if (w == 0) {
+            for (vertex_t x : stack_) {
+                match(x, arcPos_[x]);
+            }
+            return true;
+        }
+        if (distL_[w] == distL_[u] + 1) {
+            stack_.push_back(w);
+        } else {
+            arcPos_[u]++;
+        }
+    }
+    return false;
+}
+
+inline int BipartiteGraph::maxMatchingHopcroftKarp() {
+    int matching = matchingSize();
+    while (bfsLayers()) {
+        for (vertex_t u = 1; u <= n1_; ++u) {
+            arcPos_[u] = offsets_[u];
+        }
+        for (vertex_t u = 1; u <= n1_; ++u) {
+            if (matchL_[u] == 0 && augmentLayered(u)) {
+                matching++;
+            }
+        }
+    }
+    return matching;
+}
+
+// The current matching is the initial flow. Network vertices: 0 - source,
+// left u is u, right v is n1 + v, n1 + n2 + 1 - sink
+inline int BipartiteGraph::maxMatchingDinic() {
+    const int source = 0, sink = n1_ + n2_ + 1;
+    MaxFlow net(n1_ + n2_ + 2);
+    for (vertex_t u = 1; u <= n1_; ++u) {
+        net.addEdge(source, u, 1, matchL_[u] != 0);
+    }
+    for (vertex_t v = 1; v <= n2_; ++v) {
+        net.addEdge(n1_ + v, sink, 1, matchR_[v] != 0);
+    }
+    // arc a becomes edge firstArc + a
+    const int firstArc = n1_ + n2_;
+    for (vertex_t u = 1; u <= n1_; ++u) {
+        for (std::size_t a = offsets_[u]; a < offsets_[u + 1]; ++a) {
+            net.addEdge(u, n1_ + arcs_[a].v, 1, matchL_[u] != 0 && matchArc_[u] == a);
+        }
+    }
+
+    int matching = static_cast<int>(net.maxFlow(source, sink));
+    std::fill(matchL_.begin(), matchL_.end(), 0);
+    std::fill(matchR_.begin(), matchR_.end(), 0);
+    for (vertex_t u = 1; u <= n1_; ++u) {
+        for (std::size_t a = offsets_[u]; a < offsets_[u + 1]; ++a) {
+            if (net.flow(firstArc + static_cast<int>(a)) != 0) {
+                match(u, a);
+            }
+        }
+    }
+    return matching;
+}
+
+inline void BipartiteGraph::buildCover() {
+    std::fill(visL_.begin(), visL_.end(), 0);
+    std::fill(visR_.begin(), visR_.end(), 0);
+
+    for (vertex_t root = 1; root <= n1_; ++root) {
+        if (matchL_[root] != 0 || visL_[root]) {
+            continue;
+        }
+        visL_[root] = true;
+        stack_.clear();
+        stack_.push_back(root);
+        while (!stack_.empty()) {
+            vertex_t u = stack_.back();
+            stack_.pop_back();
+            for (const Arc& a : adj(u)) {
+                if (matchL_[u] == a.v || visR_[a.v]) {
+                    continue;
+                }
+                visR_[a.v] = true;
+                vertex_t w = matchR_[a.v];
+                if (w != 0 && !visL_[w]) {
+                    visL_[w] = true;
+                    stack_.push_back(w);
+                }
+            }
+        }
+    }
+}
+
+inline int BipartiteGraph::matchingSize() const {
+    return static_cast<int>(std::count_if(matchL_.begin() + 1, matchL_.end(), [](vertex_t v) { return v != 0; }));
+}
+
+inline int BipartiteGraph::initialMatching(InitStrategy strategy) {
+    std::fill(matchL_.begin(), matchL_.end(), 0);
+    std::fill(matchR_.begin(), matchR_.end(), 0);
+
+    switch (strategy) {
+    case InitStrategy::None:       return 0;
+    case InitStrategy::Greedy:     return greedy(false);
+    case InitStrategy::DegreeOne:  return greedy(true);
+    case InitStrategy::KarpSipser: return karpSipser();
+    }
+    return 0;
+}
+
+inline int BipartiteGraph::greedy(bool degreeOneFirst) {
+    int matched = 0;
+    auto take = [&](vertex_t u) {
+        std::size_t a = freeArc(u);
+        if (matchL_[u] == 0 && a != offsets_[u + 1]) {
+            match(u, a);
+            matched++;
+        }
+    };
+
+    if (degreeOneFirst) {
+        for (vertex_t u = 1; u <= n1_; ++u) {
+            if (offsets_[u + 1] - offsets_[u] == 1) {
+                take(u);
+            }
+        }
+    }
+    for (vertex_t u = 1; u <= n1_; ++u) {
+        take(u);
+    }
+    return matched;
+}
+
+// Karp-Sipser: a vertex with a single free neighbour can always be matched to it
+// without losing optimality. When there is none, the vertex of minimum degree
+// is matched instead. Degrees count arcs to free vertices, vertices sit in
+// buckets by degree and stale bucket entries are skipped when popped.
+// Vertex ids: left u is u, right v is n1 + v.
+inline int BipartiteGraph::karpSipser() {
+    const int n = n1_ + n2_;
+
+    // right side adjacency: arcs into v, as indices into arcs_
+    std::vector<std::size_t> roffsets(n2_ + 2, 0);
+    for (const Arc& a : arcs_) {
+        roffsets[a.v + 1]++;
+    }
+    for (vertex_t v = 1; v <= n2_; ++v) {
+        roffsets[v + 1] += roffsets[v];
+    }
+    std::vector<std::size_t> rarcs(arcs_.size());
+    std::vector<vertex_t> tail(arcs_.size()); // left end of every arc
+    {
+        std::vector<std::size_t> pos(roffsets.begin(), roffsets.end() - 1);
+        for (vertex_t u = 1; u <= n1_; ++u) {
+            for (std::size_t a = offsets_[u]; a < offsets_[u + 1]; ++a) {
+                rarcs[pos[arcs_[a].v]++] = a;
+                tail[a] = u;
+            }
+        }
+    }
+
+    std::vector<std::size_t> deg(n + 1, 0);
+    std::size_t maxDeg = 0;
+    for (vertex_t u = 1; u <= n1_; ++u) {
+        deg[u] = offsets_[u + 1] - offsets_[u];
+        maxDeg = std::max(maxDeg, deg[u]);
+    }
+    for (vertex_t v = 1; v <= n2_; ++v) {
+        deg[n1_ + v] = roffsets[v + 1] - roffsets[v];
+        maxDeg = std::max(maxDeg, deg[n1_ + v]);
+    }
+
+    std::vector<std::vector<int>> buckets(maxDeg + 1);
+    for (int x = 1; x <= n; ++x) {
+        if (deg[x] != 0) {
+            buckets[deg[x]].push_back(x);
+        }
+    }
+
+    auto isFree = [&](int x) { return x <= n1_ ? matchL_[x] == 0 : matchR_[x - n1_] == 0; };
+    // one free neighbour less for every arc of x
+    auto dropArcs = [&](int x, std::size_t& lowest) {
+        auto touch = [&](int z) {
+            if (isFree(z) && --deg[z] != 0) {
+                buckets[deg[z]].push_back(z);
+                lowest = std::min(lowest, deg[z]);
+            }
+        };
+        if (x <= n1_) {
+            for (const Arc& a : adj(x)) {
+                touch(n1_ + a.v);
+            }
+        } else {
+            for (std::size_t i = roffsets[x - n1_]; i < roffsets[x - n1_ + 1]; ++i) {
+                touch(tail[rarcs[i]]);
+            }
+        }
+    };
+
+    int matched = 0;
+    std::size_t d = 1;
+    while (d <= maxDeg) {
+        if (buckets[d].empty()) {
+            ++d;
+            continue;
+        }
+        int x = buckets[d].back();
+        buckets[d].pop_back();
+        if (!isFree(x) || deg[x] != d) {
+            continue; // stale entry
+        }
+
+        std::size_t arc;
+        if (x <= n1_) {
+            arc = freeArc(x);
+        } else {
+            std::size_t i = roffsets[x - n1_];
+            while (matchL_[tail[rarcs[i]]] != 0) {
+                ++i;
+            }
+            arc = rarcs[i];
+        }
+        vertex_t u = tail[arc];
+        vertex_t v = arcs_[arc].v;
+        match(u, arc);
+        matched++;
+
+        std::size_t lowest = maxDeg + 1;
+        dropArcs(u, lowest);
+        dropArcs(n1_ + v, lowest);
+        d = std::max<std::size_t>(1, std::min(d, lowest));
+    }
+    return matched;
+}
+
+// One search of a Pothen-Fan phase. Every left vertex on the path is reached
+// through a right vertex claimed by this search, so it's never touched by
+// another thread during the phase. Odd phases scan adjacency backwards (fairness).
+inline bool BipartiteGraph::augmentPothenFan(vertex_t root, unsigned phase, std::vector<vertex_t>& stack) {
+    const bool backwards = phase % 2 == 1;
+    auto start = [&](vertex_t u) { arcPos_[u] = 0; stack.push_back(u); };
+    // other threads peek at matchR_ in lookahead, so it's written atomically
+    auto flip = [&](const std::vector<vertex_t>& path) {
+        for (vertex_t x : path) {
+            vertex_t v = arcs_[via_[x]].v;
+            matchL_[x] = v;
+            matchArc_[x] = via_[x];
+            std::atomic_ref<vertex_t>(matchR_[v]).store(x, std::memory_order_relaxed);
+        }
+    };
+    stack.clear();
+    start(root);
+
+    while (!stack.empty()) {
+        vertex_t u = stack.back();
+
+        // lookahead: a free neighbour ends the path right away
+        while (lookahead_[u] < offsets_[u + 1]) {
+            std::size_t a = lookahead_[u]++;
+            vertex_t v = arcs_[a].v;
+            if (std::atomic_ref<vertex_t>(matchR_[v]).load(std::memory_order_relaxed) == 0 && claim(v, phase)) {
+                via_[u] = a;
+                flip(stack);
+                return true;
+            }
+        }
+
+        std::size_t deg = offsets_[u + 1] - offsets_[u];
+        if (arcPos_[u] == deg) {
+            stack.pop_back();
+            continue;
+        }
+        std::size_t i = arcPos_[u]++;
+        std::size_t a = backwards ? offsets_[u + 1] - 1 - i : offsets_[u] + i;
+        vertex_t v = arcs_[a].v;
+        if (!claim(v, phase)) {
+            continue;
+        }
+        via_[u] = a;
+        vertex_t w = matchR_[v]; // stable, only the claimer changes it
+        if (w == 0) {
+            flip(stack);
+            return true;
+        }
+        start(w);
+    }
+    return false;
+}
+
+// The team of threads lives for the whole run: phases are separated by a
+// barrier, the calling thread prepares the roots between them.
+inline int BipartiteGraph::maxMatchingPothenFan(unsigned threads) {
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    claimedR_ = std::make_unique<std::atomic<unsigned>[]>(n2_ + 1);
+    lookahead_.assign(offsets_.begin(), offsets_.end() - 1);
+    via_.assign(n1_ + 1, 0);
+
+    int matching = matchingSize();
+    // a matched vertex stays matched, so the roots only shrink
+    std::vector<vertex_t> roots;
+    for (vertex_t u = 1; u <= n1_; ++u) {
+        if (matchL_[u] == 0 && offsets_[u] != offsets_[u + 1]) {
+            roots.push_back(u);
+        }
+    }
+    if (roots.empty()) {
+        return matching;
+    }
+
+    unsigned phase = 0;
+    bool done = false;
+    std::atomic<std::size_t> next{0};
+    std::atomic<int> augmented{0};
+    auto search = [&](std::vector<vertex_t>& stack) {
+        int found = 0;
+        for (std::size_t i; (i = next.fetch_add(1, std::memory_order_relaxed)) < roots.size(); ) {
+            found += augmentPothenFan(roots[i], phase, stack);
+        }
+        augmented.fetch_add(found, std::memory_order_relaxed);
+    };
+
+    const unsigned team = std::min<std::size_t>(threads, roots.size());
+    std::barrier sync(team);
+    std::vector<std::jthread> pool;
+    for (unsigned t = 1; t < team; ++t) {
+        pool.emplace_back([&] {
+            std::vector<vertex_t> stack;
+            while (true) {
+                sync.arrive_and_wait(); // roots of the next phase are ready
+                if (done) {
+                    return;
+                }
+                search(stack);
+                sync.arrive_and_wait(); // phase is over
+            }
+        });
+    }
+
+    std::vector<vertex_t> stack;
+    while (true) {
+        ++phase;
+        next = 0;
+        augmented = 0;
+        sync.arrive_and_wait();
+        search(stack);
+        sync.arrive_and_wait();
+
+        // no augmenting path from any free vertex: the matching is maximum
+        if (augmented == 0) {
+            break;
+        }
+        matching += augmented;
+        std::erase_if(roots, [&](vertex_t u) { return matchL_[u] != 0; });
+        if (roots.empty()) {
+            break;
+        }
+    }
+    done = true;
+    sync.arrive_and_wait();
+    return matching;
+}
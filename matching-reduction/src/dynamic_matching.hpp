@@ -0,0 +1,333 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "bipartite_graph.hpp"
+
+// Subset of [0, n) with insert, erase and smallest element in O(log_64 n).
+// Level 0 has a bit per element, a bit of level k + 1 is set iff the
+// corresponding word of level k is nonzero.
+class IndexSet {
+    std::vector<std::vector<std::uint64_t>> levels_;
+
+public:
+    static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+    // [0, n) if full, the empty set otherwise
+    void assign(std::size_t n, bool full) {
+        std::size_t k = 0;
+        do {
+            std::size_t words = (n + 63) / 64;
+            if (k == levels_.size()) {
+                levels_.emplace_back();
+            }
+            levels_[k].assign(words, full ? ~std::uint64_t{0} : 0);
+            if (full && n % 64 != 0) {
+                levels_[k].back() = (std::uint64_t{1} << (n % 64)) - 1;
+            }
+            n = words;
+            ++k;
+        } while (n > 1);
+        levels_.resize(k);
+    }
+
+    void insert(std::size_t x) {
+        for (auto& level : levels_) {
+            std::uint64_t& w = level[x / 64];
+            bool wasEmpty = w == 0;
+            w |= std::uint64_t{1} << (x % 64);
+            if (!wasEmpty) {
+                break;
+            }
+            x /= 64;
+        }
+    }
+
+    void erase(std::size_t x) {
+        for (auto& level : levels_) {
+            std::uint64_t& w = level[x / 64];
+            w &= ~(std::uint64_t{1} << (x % 64));
+            if (w != 0) {
+                break;
+            }
+            x /= 64;
+        }
+    }
+
+    std::size_t first() const {
+        if (levels_.empty() || levels_.back().empty() || levels_.back()[0] == 0) {
+            return npos;
+        }
+        std::size_t x = 0;
+        for (auto level = levels_.rbegin(); level != levels_.rend(); ++level) {
+            x = x * 64 + std::countr_zero((*level)[x]);
+        }
+        return x;
+    }
+};
+
+// Maximum matching and Konig minimum vertex cover under edge insertions and
+// deletions. One update changes the maximum matching size by at most one, so
+// a single augmenting path search repairs it.
+//
+// The cover is kept as Z - vertices reachable by alternating paths from free
+// left vertices (cover = left vertices outside Z + right vertices in Z).
+// Updates that can't change Z cost O(1), an insertion extends Z only from the
+// new edge, the rest recompute Z in O(V + E), and that search finds the
+// augmenting path at the same time.
+class DynamicMatching {
+public:
+    using vertex_t      = BipartiteGraph::vertex_t;
+    using edge_number_t = BipartiteGraph::edge_number_t;
+
+private:
+    struct Edge {
+        vertex_t u, v;
+        std::size_t posL, posR; // positions in adjL_[u] and adjR_[v]
+        bool alive;
+    };
+
+    int n1_, n2_;
+    std::vector<Edge> edges_; // by edge number, edges_[0] is unused
+    std::vector<std::vector<edge_number_t>> adjL_, adjR_;
+
+    std::vector<vertex_t> matchL_, matchR_;
+    std::vector<edge_number_t> matchEdge_; // by left vertex
+    int size_ = 0;
+    long long weight_ = 0;                 // sum of matched edge numbers
+
+    std::vector<char> visL_, visR_;        // Z
+    IndexSet coverL_, coverR_;             // the cover: left vertices outside Z, right vertices in Z
+    std::vector<edge_number_t> reachedBy_; // edge by which a right vertex of Z was reached
+    std::vector<vertex_t> queue_;
+
+    void setMatch(vertex_t u, edge_number_t e) {
+        vertex_t v = edges_[e].v;
+        matchL_[u] = v;
+        matchR_[v] = u;
+        matchEdge_[u] = e;
+        weight_ += e;
+    }
+
+    void enterL(vertex_t u) {
+        visL_[u] = true;
+        coverL_.erase(u);
+    }
+
+    void enterR(vertex_t v) {
+        visR_[v] = true;
+        coverR_.insert(v);
+    }
+
+    void unmatch(vertex_t u) {
+        matchR_[matchL_[u]] = 0;
+        weight_ -= matchEdge_[u];
+        matchL_[u] = 0;
+        matchEdge_[u] = 0;
+        size_--;
+    }
+
+    // Alternating BFS over queue_, returns a free right vertex once one is reached, 0 if none
+    vertex_t grow(std::size_t head) {
+        while (head < queue_.size()) {
+            vertex_t x = queue_[head++];
+            for (edge_number_t e : adjL_[x]) {
+                vertex_t y = edges_[e].v;
+                if (y == matchL_[x] || visR_[y]) {
+                    continue;
+                }
+                enterR(y);
+                reachedBy_[y] = e;
+                vertex_t w = matchR_[y];
+                if (w == 0) {
+                    return y;
+                }
+                if (!visL_[w]) {
+                    enterL(w);
+                    queue_.push_back(w);
+                }
+            }
+        }
+        return 0;
+    }
+
+    // recomputes Z from scratch, returns a free right vertex of Z, 0 if none
+    vertex_t recompute() {
+        std::fill(visL_.begin(), visL_.end(), 0);
+        std::fill(visR_.begin(), visR_.end(), 0);
+        coverL_.assign(n1_ + 1, true);
+        coverL_.erase(0);
+        coverR_.assign(n2_ + 1, false);
+        queue_.clear();
+        for (vertex_t u = 1; u <= n1_; ++u) {
+            if (matchL_[u] == 0) {
+                enterL(u);
+                queue_.push_back(u);
+            }
+        }
+        return grow(0);
+    }
+
+    // flips the alternating path of Z that ends at free right vertex y
+    void augment(vertex_t y) {
+        while (true) {
+            edge_number_t e = reachedBy_[y];
+            vertex_t x = edges_[e].u;
+            vertex_t prev = matchL_[x];
+            if (prev != 0) {
+                weight_ -= matchEdge_[x];
+            }
+            setMatch(x, e);
+            if (prev == 0) {
+                break;
+            }
+            y = prev;
+        }
+        size_++;
+    }
+
+    static vertex_t firstOf(const IndexSet& s) {
+        std::size_t x = s.first();
+        return x == IndexSet::npos ? 0 : static_cast<vertex_t>(x);
+    }
+
+    // restores a maximum matching after at most one augmentation and rebuilds Z
+    void repair() {
+        if (vertex_t y = recompute(); y != 0) {
+            augment(y);
+            recompute();
+        }
+    }
+
+    // unlinks e from the graph, returns true if it was matched
+    bool detach(edge_number_t e) {
+        Edge& ed = edges_[e];
+        auto drop = [&](std::vector<edge_number_t>& list, std::size_t pos, bool left) {
+            edge_number_t moved = list.back();
+            list[pos] = moved;
+            (left ? edges_[moved].posL : edges_[moved].posR) = pos;
+            list.pop_back();
+        };
+        drop(adjL_[ed.u], ed.posL, true);
+        drop(adjR_[ed.v], ed.posR, false);
+        ed.alive = false;
+
+        if (matchEdge_[ed.u] == e) {
+            unmatch(ed.u);
+            return true;
+        }
+        return false;
+    }
+
+public:
+    // edges[i] gets number i + 1, the initial matching is found by Hopcroft-Karp
+    DynamicMatching(int n1, int n2, const std::vector<std::pair<vertex_t, vertex_t>>& edges = {})
+        : n1_(n1), n2_(n2), edges_(1), adjL_(n1 + 1), adjR_(n2 + 1),
+          matchL_(n1 + 1, 0), matchR_(n2 + 1, 0), matchEdge_(n1 + 1, 0),
+          visL_(n1 + 1, 0), visR_(n2 + 1, 0), reachedBy_(n2 + 1, 0) {
+        BipartiteGraph g(n1, n2, edges); // also checks endpoints
+        g.maxMatchingHopcroftKarp();
+        for (auto [u, v] : edges) {
+            edges_.push_back({u, v, adjL_[u].size(), adjR_[v].size(), true});
+            adjL_[u].push_back(edges_.size() - 1);
+            adjR_[v].push_back(edges_.size() - 1);
+        }
+        for (vertex_t u = 1; u <= n1; ++u) {
+            if (g.matchL(u) != 0) {
+                setMatch(u, g.matchedEdge(u));
+                size_++;
+            }
+        }
+        recompute();
+    }
+
+    int leftSize() const { return n1_; }
+    int rightSize() const { return n2_; }
+
+    // Adds edge (u, v) with the next edge number and returns it
+    edge_number_t addEdge(vertex_t u, vertex_t v) {
+        if (u < 1 || u > n1_ || v < 1 || v > n2_) {
+            throw std::out_of_range("DynamicMatching: edge endpoint out of range");
+        }
+        edge_number_t e = edges_.size();
+        edges_.push_back({u, v, adjL_[u].size(), adjR_[v].size(), true});
+        adjL_[u].push_back(e);
+        adjR_[v].push_back(e);
+
+        // an augmenting path or a new vertex of Z has to come through u -> v with u in Z
+        if (!visL_[u] || v == matchL_[u] || visR_[v]) {
+            return e;
+        }
+        enterR(v);
+        reachedBy_[v] = e;
+        vertex_t y = v;
+        if (vertex_t w = matchR_[v]; w != 0) {
+            y = 0;
+            if (!visL_[w]) {
+                enterL(w);
+                queue_.assign(1, w);
+                y = grow(0);
+            }
+        }
+        if (y != 0) {
+            augment(y);
+            recompute();
+        }
+        return e;
+    }
+
+    // returns false if there is no such edge (or it was removed already)
+    bool removeEdge(edge_number_t e) {
+        if (e < 1 || e >= static_cast<edge_number_t>(edges_.size()) || !edges_[e].alive) {
+            return false;
+        }
+        vertex_t u = edges_[e].u;
+        bool wasMatched = detach(e);
+        // an unmatched edge leaving a left vertex outside Z isn't used by Z
+        if (wasMatched || visL_[u]) {
+            repair();
+        }
+        return true;
+    }
+
+    // removes all edges of the vertex, one repair for all of them
+    void removeVertexL(vertex_t u) {
+        while (!adjL_[u].empty()) {
+            detach(adjL_[u].back());
+        }
+        repair();
+    }
+    void removeVertexR(vertex_t v) {
+        while (!adjR_[v].empty()) {
+            detach(adjR_[v].back());
+        }
+        repair();
+    }
+
+    int matchingSize() const { return size_; }
+    long long matchingWeight() const { return weight_; }
+    vertex_t matchL(vertex_t u) const { return matchL_[u]; }
+    vertex_t matchR(vertex_t v) const { return matchR_[v]; }
+    edge_number_t matchedEdge(vertex_t u) const { return matchEdge_[u]; }
+
+    bool inCoverL(vertex_t u) const { return !visL_[u]; }
+    bool inCoverR(vertex_t v) const { return visR_[v]; }
+    // smallest vertex of the cover on that side, 0 if there is none
+    vertex_t firstCoverL() const { return firstOf(coverL_); }
+    vertex_t firstCoverR() const { return firstOf(coverR_); }
+
+    // live edges of left vertex u
+    std::vector<std::pair<vertex_t, edge_number_t>> adj(vertex_t u) const {
+        std::vector<std::pair<vertex_t, edge_number_t>> res;
+        for (edge_number_t e : adjL_[u]) {
+            res.push_back({edges_[e].v, e});
+        }
+        return res;
+    }
+};
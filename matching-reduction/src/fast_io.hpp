@@ -0,0 +1,148 @@
+#pragma once
+
+#include <cerrno>
+#include <charconv>
+#include <cstddef>
+#include <cstring>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#include <unistd.h>
+
+// Buffered integer I/O straight on file descriptors.
+// FastReader uses read(2), which returns whatever is available, so it never
+// waits for a full buffer and works with interactive judges.
+
+class FastReader {
+    int fd_;
+    std::vector<char> buf_;
+    std::size_t pos_ = 0;
+    std::size_t len_ = 0;
+
+    bool refill() {
+        pos_ = 0;
+        ssize_t got;
+        do {
+            got = ::read(fd_, buf_.data(), buf_.size());
+        } while (got < 0 && errno == EINTR);
+        len_ = got > 0 ? static_cast<std::size_t>(got) : 0;
+        return len_ != 0;
+    }
+
+    // next byte without consuming it, -1 on end of input
+    int peek() {
+        if (pos_ == len_ && !refill()) {
+            return -1;
+        }
+        return static_cast<unsigned char>(buf_[pos_]);
+    }
+
+public:
+    explicit FastReader(int fd = 0, std::size_t bufSize = 1 << 16) : fd_(fd), buf_(bufSize) {}
+
+    // Skips whitespace and parses an optionally signed decimal integer.
+    // Returns false at end of input, throws std::runtime_error on other characters.
+    template<typename Int>
+    bool read(Int& x) {
+        static_assert(std::is_integral_v<Int>);
+        int c = peek();
+        while (c == ' ' || c == '\n' || c == '\r' || c == '\t') {
+            ++pos_;
+            c = peek();
+        }
+        if (c == -1) {
+            return false;
+        }
+
+        bool negative = c == '-';
+        if (negative) {
+            ++pos_;
+            c = peek();
+        }
+        if (c < '0' || c > '9') {
+            throw std::runtime_error("FastReader: integer expected");
+        }
+        std::make_unsigned_t<Int> value = 0;
+        while (c >= '0' && c <= '9') {
+            value = value * 10 + (c - '0');
+            ++pos_;
+            c = peek();
+        }
+        x = static_cast<Int>(negative ? 0 - value : value);
+        return true;
+    }
+
+    // throws std::runtime_error at end of input
+    template<typename Int>
+    Int next() {
+        Int x;
+        if (!read(x)) {
+            throw std::runtime_error("FastReader: unexpected end of input");
+        }
+        return x;
+    }
+};
+
+class FastWriter {
+    int fd_;
+    std::vector<char> buf_;
+    std::size_t len_ = 0;
+
+    void writeAll(const char* data, std::size_t size) {
+        while (size != 0) {
+            ssize_t put = ::write(fd_, data, size);
+            if (put < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                throw std::runtime_error("FastWriter: write failed");
+            }
+            data += put;
+            size -= put;
+        }
+    }
+
+public:
+    explicit FastWriter(int fd = 1, std::size_t bufSize = 1 << 16) : fd_(fd), buf_(bufSize) {}
+    ~FastWriter() {
+        try {
+            flush();
+        } catch (...) {
+        }
+    }
+    FastWriter(const FastWriter&) = delete;
+    FastWriter& operator=(const FastWriter&) = delete;
+
+    void flush() {
+        writeAll(buf_.data(), len_);
+        len_ = 0;
+    }
+
+    void put(char c) {
+        if (len_ == buf_.size()) {
+            flush();
+        }
+        buf_[len_++] = c;
+    }
+
+    // bytes larger than the buffer go out in one write
+    void write(const char* data, std::size_t size) {
+        if (len_ + size > buf_.size()) {
+            flush();
+            if (size > buf_.size()) {
+                writeAll(data, size);
+                return;
+            }
+        }
+        std::memcpy(buf_.data() + len_, data, size);
+        len_ += size;
+    }
+
+    template<typename Int>
+    void writeInt(Int x) {
+        char tmp[24];
+        auto res = std::to_chars(tmp, tmp + sizeof(tmp), x);
+        write(tmp, res.ptr - tmp);
+    }
+};
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+// Seeded bipartite instances for tests and benchmarks, the same seed gives
+// the same instance.
+//  - Random: both endpoints uniform
+//  - PowerLaw: endpoint of rank r is drawn with probability ~ 1 / r
+//    (Zipf), ranks are shuffled so hubs are spread over the ids
+//  - KuhnWorstCase: left u has edges to right u - 1, then to right u. Without
+//    an initial matching, Kuhn's search from u walks the whole chain
+//    u - 1, u - 2, ..., 1 before it finds right u, O(n^2) in total.
+//    Deterministic, the seed and m are not used
+
+enum class InstanceKind { Random, PowerLaw, KuhnWorstCase };
+
+struct Instance {
+    int n1 = 0, n2 = 0;
+    std::vector<std::pair<int, int>> edges;
+};
+
+namespace instance_detail {
+
+// samples 1..n with P(id) ~ 1 / rank(id)
+class ZipfSampler {
+    std::vector<double> cdf_;
+    std::vector<int> ids_; // ids by rank
+
+public:
+    ZipfSampler(int n, std::mt19937_64& gen) : cdf_(n), ids_(n) {
+        double sum = 0;
+        for (int r = 0; r < n; ++r) {
+            sum += 1.0 / (r + 1);
+            cdf_[r] = sum;
+        }
+        std::iota(ids_.begin(), ids_.end(), 1);
+        std::shuffle(ids_.begin(), ids_.end(), gen);
+    }
+
+    int operator()(std::mt19937_64& gen) const {
+        double x = std::uniform_real_distribution<double>(0, cdf_.back())(gen);
+        auto r = std::lower_bound(cdf_.begin(), cdf_.end(), x) - cdf_.begin();
+        return ids_[std::min<std::size_t>(r, ids_.size() - 1)];
+    }
+};
+
+} // namespace instance_detail
+
+inline Instance generateInstance(InstanceKind kind, int n1, int n2, int m, std::uint64_t seed) {
+    if (n1 < 1 || n2 < 1 || m < 0) {
+        throw std::invalid_argument("generateInstance: bad sizes");
+    }
+    Instance inst{n1, n2, {}};
+    std::mt19937_64 gen(seed);
+
+    switch (kind) {
+    case InstanceKind::Random:
+        inst.edges.resize(m);
+        for (auto& [u, v] : inst.edges) {
+            u = static_cast<int>(gen() % n1) + 1;
+            v = static_cast<int>(gen() % n2) + 1;
+        }
+        break;
+    case InstanceKind::PowerLaw: {
+        instance_detail::ZipfSampler left(n1, gen), right(n2, gen);
+        inst.edges.resize(m);
+        for (auto& [u, v] : inst.edges) {
+            u = left(gen);
+            v = right(gen);
+        }
+        break;
+    }
+    case InstanceKind::KuhnWorstCase: {
+        int n = std::min(n1, n2);
+        for (int u = 1; u <= n; ++u) {
+            if (u > 1) {
+                inst.edges.push_back({u, u - 1});
+            }
+            inst.edges.push_back({u, u});
+        }
+        break;
+    }
+    }
+    return inst;
+}
@@ -0,0 +1,258 @@
+#include <bits/stdc++.h>
+
+#include "bipartite_graph.hpp"
+#include "dynamic_matching.hpp"
+#include "fast_io.hpp"
+#include "weighted_matching.hpp"
+
+using namespace std;
+
+int n1, n2, m, q;
+
+using vertex_t      = BipartiteGraph::vertex_t;
+using edge_number_t = BipartiteGraph::edge_number_t;
+
+using InitStrategy = BipartiteGraph::InitStrategy;
+
+const map<string, InitStrategy> INIT_STRATEGIES = {
+    {"none",   InitStrategy::None},
+    {"greedy", InitStrategy::Greedy},
+    {"deg1",   InitStrategy::DegreeOne},
+    {"ks",     InitStrategy::KarpSipser},
+};
+
+enum class Engine { HopcroftKarp, Kuhn, PothenFan, Dinic };
+
+const map<string, Engine> ENGINES = {
+    {"hk",    Engine::HopcroftKarp},
+    {"kuhn",  Engine::Kuhn},
+    {"pf",    Engine::PothenFan},
+    {"dinic", Engine::Dinic},
+};
+
+enum class WeightedEngine { None, Hungarian, Auction };
+
+const map<string, WeightedEngine> WEIGHTED_ENGINES = {
+    {"hungarian", WeightedEngine::Hungarian},
+    {"auction",   WeightedEngine::Auction},
+};
+
+const char* USAGE = " [--init none|greedy|deg1|ks] [--engine hk|kuhn|pf|dinic] [--threads N] [--stats] [--offline] [--dynamic]"
+                    " [--weighted hungarian|auction] < input\n";
+
+// Dynamic mode: the graph changes between queries, the matching and the cover
+// are repaired after every update instead of being computed once.
+//   1        - remove a vertex of the minimum cover: "1", the vertex, weight of the matching
+//   2        - the matching: its size and edge numbers
+//   3 u v    - add edge (u, v), it gets the next edge number: new matching size
+//   4 idx    - remove edge idx: new matching size
+void runDynamic(FastReader& in, FastWriter& out, const vector<pair<vertex_t, vertex_t>>& edges, bool offline) {
+    DynamicMatching dm(n1, n2, edges);
+
+    while (q--) {
+        int t = in.next<int>();
+        if (t == 1) {
+            vertex_t x = dm.firstCoverL();
+            if (x == 0) {
+                x = -dm.firstCoverR(); // negative because vertex from right side
+            }
+            if (x > 0) {
+                dm.removeVertexL(x);
+            } else if (x < 0) {
+                dm.removeVertexR(-x);
+            }
+            out.writeInt(x != 0 ? 1 : 0);
+            out.put('\n');
+            out.writeInt(x);
+            out.put('\n');
+            out.writeInt(dm.matchingWeight());
+            out.put('\n');
+        } else if (t == 2) {
+            out.writeInt(dm.matchingSize());
+            out.put('\n');
+            int printed = 0;
+            for (vertex_t u = 1; u <= n1; ++u) {
+                if (dm.matchL(u) != 0) {
+                    out.writeInt(dm.matchedEdge(u));
+                    out.put(++printed == dm.matchingSize() ? '\n' : ' ');
+                }
+            }
+        } else if (t == 3) {
+            vertex_t u = in.next<int>();
+            vertex_t v = in.next<int>();
+            dm.addEdge(u, v);
+            out.writeInt(dm.matchingSize());
+            out.put('\n');
+        } else {
+            dm.removeEdge(in.next<int>());
+            out.writeInt(dm.matchingSize());
+            out.put('\n');
+        }
+        if (!offline) {
+            out.flush();
+        }
+    }
+}
+
+// Weighted mode: maximum weight matching where the weight of an edge is its
+// number, printed once as "size weight" and the edge numbers. Queries are ignored.
+void runWeighted(FastWriter& out, const vector<pair<vertex_t, vertex_t>>& edges, WeightedEngine engine, unsigned threads) {
+    vector<WeightedEdge> weighted(edges.size());
+    for (size_t i = 0; i < edges.size(); ++i) {
+        weighted[i] = {edges[i].first, edges[i].second, static_cast<long long>(i + 1)};
+    }
+    WeightedMatching res = engine == WeightedEngine::Hungarian ? hungarianMaxWeight(n1, n2, weighted)
+                                                               : auctionMaxWeight(n1, n2, weighted, threads);
+    int size = res.size();
+    out.writeInt(size);
+    out.put(' ');
+    out.writeInt(res.weight);
+    out.put('\n');
+    int printed = 0;
+    for (vertex_t u = 1; u <= n1; ++u) {
+        if (res.edgeL[u] != 0) {
+            out.writeInt(res.edgeL[u]);
+            out.put(++printed == size ? '\n' : ' ');
+        }
+    }
+    if (size == 0) {
+        out.put('\n');
+    }
+}
+
+// --stats reports to stderr how much of the matching the initial heuristic found
+// --threads is for the parallel Pothen-Fan engine and the auction, 0 (default) - all cores
+// --offline doesn't flush after every answer, for inputs with all queries known upfront
+int main(int argc, char* argv[]) {
+    // Kuhn from the empty matching by default: the answers depend on which maximum
+    // matching is found, and these are the ones the original solution printed
+    InitStrategy init = InitStrategy::None;
+    Engine engine = Engine::Kuhn;
+    unsigned threads = 0;
+    bool stats = false;
+    bool offline = false;
+    bool dynamic = false;
+    WeightedEngine weighted = WeightedEngine::None;
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        if (arg == "--init" && i + 1 < argc && INIT_STRATEGIES.contains(argv[i + 1])) {
+            init = INIT_STRATEGIES.at(argv[++i]);
+        } else if (arg == "--engine" && i + 1 < argc && ENGINES.contains(argv[i + 1])) {
+            engine = ENGINES.at(argv[++i]);
+        } else if (arg == "--threads" && i + 1 < argc) {
+            threads = stoul(argv[++i]);
+        } else if (arg == "--stats") {
+            stats = true;
+        } else if (arg == "--offline") {
+            offline = true;
+        } else if (arg == "--dynamic") {
+            dynamic = true;
+        } else if (arg == "--weighted" && i + 1 < argc && WEIGHTED_ENGINES.contains(argv[i + 1])) {
+            weighted = WEIGHTED_ENGINES.at(argv[++i]);
+        } else {
+            cerr << "usage: " << argv[0] << USAGE;
+            return 1;
+        }
+    }
+
+    FastReader in;
+    FastWriter out;
+
+    n1 = in.next<int>();
+    n2 = in.next<int>();
+    m = in.next<int>();
+    q = in.next<int>();
+    vector<pair<vertex_t, vertex_t>> edges(m);
+    for (auto& [u, v] : edges) {
+        u = in.next<int>();
+        v = in.next<int>();
+    }
+    if (weighted != WeightedEngine::None) {
+        runWeighted(out, edges, weighted, threads);
+        return 0;
+    }
+    if (dynamic) {
+        runDynamic(in, out, edges, offline);
+        return 0;
+    }
+    BipartiteGraph g(n1, n2, edges);
+
+    int initial = g.initialMatching(init);
+
+    // Ford-Fulkerson
+    int matching = 0;
+    switch (engine) {
+    case Engine::HopcroftKarp: matching = g.maxMatchingHopcroftKarp(); break;
+    case Engine::Kuhn:         matching = g.maxMatchingKuhn(); break;
+    case Engine::PothenFan:    matching = g.maxMatchingPothenFan(threads); break;
+    case Engine::Dinic:        matching = g.maxMatchingDinic(); break;
+    }
+    if (stats) {
+        cerr << "initial matching: " << initial << " of " << matching
+             << " (" << (matching != 0 ? 100.0 * initial / matching : 100.0) << "%), "
+             << "augmented: " << matching - initial << '\n';
+    }
+
+    // Min vertex cover
+    g.buildCover();
+
+    vector<vertex_t> remVertex;
+    vector<edge_number_t> remEdge;
+
+    size_t sum = 0;
+
+    for (vertex_t u = 1; u <= n1; ++u) {
+        if (g.inCoverL(u)) {
+            remVertex.push_back(u);
+            remEdge.push_back(g.matchedEdge(u));
+            sum += remEdge.back();
+        }
+    }
+
+    for (vertex_t v = 1; v <= n2; ++v) {
+        if (g.inCoverR(v)) {
+            remVertex.push_back(-v); // negative because vertex from right side
+            remEdge.push_back(g.matchedEdge(g.matchR(v)));
+            sum += remEdge.back();
+        }
+    }
+
+    // Remaining edges pre-formatted once: "e1 e2 ... ek\n", edge i starts at
+    // suffixStart[i], so a type 2 answer is one copy of a byte range
+    string suffix;
+    vector<size_t> suffixStart(remEdge.size() + 1);
+    for (size_t i = 0; i < remEdge.size(); ++i) {
+        suffixStart[i] = suffix.size();
+        char tmp[16];
+        auto res = to_chars(tmp, tmp + sizeof(tmp), remEdge[i]);
+        suffix.append(tmp, res.ptr);
+        suffix += i + 1 == remEdge.size() ? '\n' : ' ';
+    }
+    suffixStart[remEdge.size()] = suffix.size();
+
+    size_t removed = 0;
+
+    while (q--) {
+        int t = in.next<int>();
+        if (t == 1) {
+            out.writeInt(1);
+            out.put('\n');
+            out.writeInt(remVertex[removed]);
+            out.put('\n');
+            sum -= remEdge[removed];
+            ++removed;
+            out.writeInt(sum);
+            out.put('\n');
+        } else {
+            out.writeInt(remEdge.size() - removed);
+            out.put('\n');
+            out.write(suffix.data() + suffixStart[removed], suffix.size() - suffixStart[removed]);
+        }
+        // the judge sends the next query only after reading this answer
+        if (!offline) {
+            out.flush();
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,247 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+// Maximum flow by Dinic's algorithm, O(V^2 * E) in general, O(E * sqrt(V))
+// on unit networks such as bipartite matching.
+// Vertices are 0..n-1, edges are numbered from 0 in the order of addEdge.
+// The residual network is built in CSR form on the first maxFlow call
+// (one array of arcs, offsets per vertex, every arc knows its reverse arc),
+// blocking flows are found by an iterative dfs with current-arc pointers.
+class MaxFlow {
+public:
+    using cap_t = long long;
+    static constexpr cap_t Inf = std::numeric_limits<cap_t>::max() / 4;
+
+private:
+    struct Edge {
+        int from, to;
+        cap_t cap, flow;
+    };
+
+    int n_;
+    std::vector<Edge> edges_;
+    std::vector<cap_t> vertexCap_; // Inf - no limit
+    bool built_ = false;
+
+    // a vertex with a capacity is split: arcs come into x and leave from out_[x],
+    // x -> out_[x] carries the capacity. out_[x] == x for the others
+    std::vector<int> out_;
+    int nodes_ = 0;
+
+    std::vector<std::size_t> head_; // arcs of node x are [head_[x], head_[x + 1])
+    // head and residual capacity are read together by both searches
+    struct Arc {
+        int to;
+        cap_t res;
+    };
+    std::vector<Arc> arcs_;
+    std::vector<std::size_t> pair_; // reverse arc
+    std::vector<std::size_t> edgeArc_;
+
+    std::vector<int> level_;        // BFS layer, -1 if not reached
+    std::vector<std::size_t> cur_;  // current arc of the phase
+    std::vector<int> queue_;
+    std::vector<std::size_t> path_; // arcs from the source to the dfs head
+
+    void build();
+    bool bfsLevels(int s, int t);
+    void blockingFlow(int s, int t);
+
+public:
+    explicit MaxFlow(int n) : n_(n), vertexCap_(n, Inf) {}
+
+    int vertexCount() const { return n_; }
+
+    // Edge from -> to with capacity cap carrying flow already, returns its number.
+    // Edges can't be added after maxFlow
+    int addEdge(int from, int to, cap_t cap, cap_t flow = 0) {
+        if (built_) {
+            throw std::logic_error("MaxFlow: edge added after maxFlow");
+        }
+        if (from < 0 || from >= n_ || to < 0 || to >= n_) {
+            throw std::out_of_range("MaxFlow: edge endpoint out of range");
+        }
+        if (flow < 0 || flow > cap) {
+            throw std::invalid_argument("MaxFlow: initial flow out of [0, cap]");
+        }
+        edges_.push_back({from, to, cap, flow});
+        return static_cast<int>(edges_.size() - 1);
+    }
+
+    // At most cap units of flow pass through v
+    void setVertexCapacity(int v, cap_t cap) {
+        if (built_) {
+            throw std::logic_error("MaxFlow: vertex capacity set after maxFlow");
+        }
+        vertexCap_.at(v) = cap;
+    }
+
+    // Augments the current flow to a maximum s-t flow, returns its value
+    cap_t maxFlow(int s, int t);
+
+    cap_t flow(int edge) const {
+        return edges_[edge].cap - arcs_[edgeArc_[edge]].res;
+    }
+
+    // Minimum cut of the last maxFlow: the source side is what the source
+    // reaches in the residual network (the last BFS doesn't reach t, so it's complete)
+    bool onSourceSide(int v) const { return level_[v] != -1; }
+    // capacity of v is in the cut
+    bool vertexInCut(int v) const { return level_[v] != -1 && level_[out_[v]] == -1; }
+    std::vector<int> cutEdges() const {
+        std::vector<int> res;
+        for (std::size_t e = 0; e < edges_.size(); ++e) {
+            if (level_[out_[edges_[e].from]] != -1 && level_[edges_[e].to] == -1) {
+                res.push_back(static_cast<int>(e));
+            }
+        }
+        return res;
+    }
+};
+
+inline void MaxFlow::build() {
+    out_.resize(n_);
+    nodes_ = n_;
+    for (int x = 0; x < n_; ++x) {
+        out_[x] = vertexCap_[x] != Inf ? nodes_++ : x;
+    }
+
+    // every edge and every split vertex gives a forward and a reverse arc
+    std::vector<cap_t> through(n_, 0); // initial flow into x
+    head_.assign(nodes_ + 1, 0);
+    for (const Edge& e : edges_) {
+        head_[out_[e.from] + 1]++;
+        head_[e.to + 1]++;
+        through[e.to] += e.flow;
+    }
+    for (int x = 0; x < n_; ++x) {
+        if (out_[x] != x) {
+            head_[x + 1]++;
+            head_[out_[x] + 1]++;
+        }
+    }
+    for (int x = 0; x < nodes_; ++x) {
+        head_[x + 1] += head_[x];
+    }
+
+    arcs_.resize(head_[nodes_]);
+    pair_.resize(head_[nodes_]);
+    std::vector<std::size_t> pos(head_.begin(), head_.end() - 1);
+    auto link = [&](int from, int to, cap_t cap, cap_t flow) {
+        std::size_t a = pos[from]++, b = pos[to]++;
+        arcs_[a] = {to, cap - flow};
+        pair_[a] = b;
+        arcs_[b] = {from, flow};
+        pair_[b] = a;
+        return a;
+    };
+    edgeArc_.resize(edges_.size());
+    for (std::size_t e = 0; e < edges_.size(); ++e) {
+        edgeArc_[e] = link(out_[edges_[e].from], edges_[e].to, edges_[e].cap, edges_[e].flow);
+    }
+    for (int x = 0; x < n_; ++x) {
+        if (out_[x] != x) {
+            link(x, out_[x], vertexCap_[x], std::min(through[x], vertexCap_[x]));
+        }
+    }
+
+    level_.assign(nodes_, -1);
+    cur_.resize(nodes_);
+    built_ = true;
+}
+
+inline bool MaxFlow::bfsLevels(int s, int t) {
+    std::fill(level_.begin(), level_.end(), -1);
+    queue_.clear();
+    queue_.push_back(s);
+    level_[s] = 0;
+    for (std::size_t head = 0; head < queue_.size(); ++head) {
+        int x = queue_[head];
+        // nodes at the layer of t or deeper are never on a shortest path
+        if (level_[t] != -1 && level_[x] >= level_[t]) {
+            break;
+        }
+        for (std::size_t a = head_[x]; a < head_[x + 1]; ++a) {
+            if (arcs_[a].res != 0 && level_[arcs_[a].to] == -1) {
+                level_[arcs_[a].to] = level_[x] + 1;
+                queue_.push_back(arcs_[a].to);
+            }
+        }
+    }
+    return level_[t] != -1;
+}
+
+// Iterative dfs along the level graph: path_ holds the arcs from s to the
+// head x. At t the path is saturated and cut back to its first saturated arc,
+// a node without a way forward leaves the level graph
+inline void MaxFlow::blockingFlow(int s, int t) {
+    path_.clear();
+    int x = s;
+    while (true) {
+        if (x == t) {
+            cap_t f = Inf;
+            for (std::size_t a : path_) {
+                f = std::min(f, arcs_[a].res);
+            }
+            for (std::size_t a : path_) {
+                arcs_[a].res -= f;
+                arcs_[pair_[a]].res += f;
+            }
+
+            std::size_t k = 0;
+            while (arcs_[path_[k]].res != 0) {
+                ++k;
+            }
+            path_.resize(k);
+            x = k == 0 ? s : arcs_[path_[k - 1]].to;
+            continue;
+        }
+
+        std::size_t& a = cur_[x];
+        while (a < head_[x + 1] && (arcs_[a].res == 0 || level_[arcs_[a].to] != level_[x] + 1)) {
+            ++a;
+        }
+        if (a < head_[x + 1]) {
+            path_.push_back(a);
+            x = arcs_[a].to;
+            continue;
+        }
+
+        level_[x] = -1;
+        if (path_.empty()) {
+            break;
+        }
+        path_.pop_back();
+        x = path_.empty() ? s : arcs_[path_.back()].to;
+        ++cur_[x];
+    }
+}
+
+inline MaxFlow::cap_t MaxFlow::maxFlow(int s, int t) {
+    if (s < 0 || s >= n_ || t < 0 || t >= n_ || s == t) {
+        throw std::invalid_argument("MaxFlow: bad source or sink");
+    }
+    if (!built_) {
+        build();
+    }
+    while (bfsLevels(s, t)) {
+        std::copy(head_.begin(), head_.end() - 1, cur_.begin());
+        blockingFlow(s, t);
+    }
+
+    cap_t value = 0;
+    for (std::size_t e = 0; e < edges_.size(); ++e) {
+        if (edges_[e].from == s) {
+            value += flow(e);
+        }
+        if (edges_[e].to == s) {
+            value -= flow(e);
+        }
+    }
+    return value;
+}
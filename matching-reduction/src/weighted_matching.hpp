@@ -0,0 +1,452 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <barrier>
+#include <cstddef>
+#include <limits>
+#include <optional>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// Weighted bipartite matching on the same graphs as "bipartite_graph.hpp":
+// left vertices 1..n1, right vertices 1..n2, edges numbered from 1 in input order.
+//  - Hungarian algorithm with potentials, O(n^3) on a dense cost matrix
+//  - epsilon-scaling auction on threads, for large sparse graphs
+
+struct WeightedEdge {
+    int u, v;
+    long long w;
+};
+
+struct WeightedMatching {
+    long long weight = 0;
+    std::vector<int> edgeL; // number of the edge matching left vertex u, 0 if u is free
+
+    int size() const {
+        return static_cast<int>(std::count_if(edgeL.begin(), edgeL.end(), [](int e) { return e != 0; }));
+    }
+};
+
+namespace weighted_detail {
+
+inline void checkEdges(int n1, int n2, const std::vector<WeightedEdge>& edges) {
+    for (const WeightedEdge& e : edges) {
+        if (e.u < 1 || e.u > n1 || e.v < 1 || e.v > n2) {
+            throw std::out_of_range("weighted matching: edge endpoint out of range");
+        }
+    }
+}
+
+// Minimum cost assignment of every row to a distinct column of an n x m
+// matrix (n <= m, 1-based) by shortest augmenting paths with potentials.
+// Returns rowOf[j] - the row assigned to column j (0 if none).
+inline std::vector<int> assign(int n, int m, const std::vector<long long>& cost) {
+    const long long Inf = std::numeric_limits<long long>::max() / 4;
+    auto a = [&](int i, int j) { return cost[static_cast<std::size_t>(i) * (m + 1) + j]; };
+
+    std::vector<long long> pu(n + 1, 0), pv(m + 1, 0), minv(m + 1);
+    std::vector<int> rowOf(m + 1, 0), way(m + 1, 0);
+    std::vector<char> used(m + 1);
+    for (int i = 1; i <= n; ++i) {
+        // column 0 is a virtual start holding row i
+        rowOf[0] = i;
+        int j0 = 0;
+        std::fill(minv.begin(), minv.end(), Inf);
+        std::fill(used.begin(), used.end(), 0);
+        do {
+            used[j0] = true;
+            int i0 = rowOf[j0];
+            int j1 = 0;
+            long long delta = Inf;
+            for (int j = 1; j <= m; ++j) {
+                if (used[j]) {
+                    continue;
+                }
+                long long cur = a(i0, j) - pu[i0] - pv[j];
+                if (cur < minv[j]) {
+                    minv[j] = cur;
+                    way[j] = j0;
+                }
+                if (minv[j] < delta) {
+                    delta = minv[j];
+                    j1 = j;
+                }
+            }
+            for (int j = 0; j <= m; ++j) {
+                if (used[j]) {
+                    pu[rowOf[j]] += delta;
+                    pv[j] -= delta;
+                } else {
+                    minv[j] -= delta;
+                }
+            }
+            j0 = j1;
+        } while (rowOf[j0] != 0);
+
+        // flip the path back to the start
+        do {
+            int j1 = way[j0];
+            rowOf[j0] = rowOf[j1];
+            j0 = j1;
+        } while (j0 != 0);
+    }
+    return rowOf;
+}
+
+// Dense matrix of the best parallel edge for every pair, rows are the smaller
+// side. better(a, b) tells whether edge a is preferred over edge b.
+template<typename Better>
+std::vector<int> bestEdges(int n1, int n2, bool transpose, const std::vector<WeightedEdge>& edges, Better better) {
+    int m = transpose ? n1 : n2;
+    int n = transpose ? n2 : n1;
+    std::vector<int> best(static_cast<std::size_t>(n + 1) * (m + 1), 0);
+    for (std::size_t k = 0; k < edges.size(); ++k) {
+        int i = transpose ? edges[k].v : edges[k].u;
+        int j = transpose ? edges[k].u : edges[k].v;
+        int& cur = best[static_cast<std::size_t>(i) * (m + 1) + j];
+        if (cur == 0 || better(edges[k], edges[cur - 1])) {
+            cur = static_cast<int>(k + 1);
+        }
+    }
+    return best;
+}
+
+} // namespace weighted_detail
+
+// Maximum weight matching (not necessarily perfect), edges with w <= 0 are never taken
+inline WeightedMatching hungarianMaxWeight(int n1, int n2, const std::vector<WeightedEdge>& edges) {
+    weighted_detail::checkEdges(n1, n2, edges);
+    bool transpose = n1 > n2;
+    int n = transpose ? n2 : n1;
+    int m = transpose ? n1 : n2;
+
+    auto best = weighted_detail::bestEdges(n1, n2, transpose, edges,
+                                           [](const WeightedEdge& a, const WeightedEdge& b) { return a.w > b.w; });
+    // a missing edge costs 0, the same as leaving the row unmatched
+    std::vector<long long> cost(best.size(), 0);
+    for (std::size_t k = 0; k < best.size(); ++k) {
+        if (best[k] != 0) {
+            cost[k] = -std::max(0LL, edges[best[k] - 1].w);
+        }
+    }
+
+    auto rowOf = weighted_detail::assign(n, m, cost);
+    WeightedMatching res;
+    res.edgeL.assign(n1 + 1, 0);
+    for (int j = 1; j <= m; ++j) {
+        int i = rowOf[j];
+        int e = i != 0 ? best[static_cast<std::size_t>(i) * (m + 1) + j] : 0;
+        if (e != 0 && edges[e - 1].w > 0) {
+            res.edgeL[edges[e - 1].u] = e;
+            res.weight += edges[e - 1].w;
+        }
+    }
+    return res;
+}
+
+// Minimum cost matching covering every left vertex (n1 <= n2), nullopt if there is none
+inline std::optional<WeightedMatching> hungarianMinCostPerfect(int n1, int n2, const std::vector<WeightedEdge>& edges) {
+    weighted_detail::checkEdges(n1, n2, edges);
+    if (n1 > n2) {
+        return std::nullopt;
+    }
+
+    auto best = weighted_detail::bestEdges(n1, n2, false, edges,
+                                           [](const WeightedEdge& a, const WeightedEdge& b) { return a.w < b.w; });
+    // a missing edge costs more than any matching made of real edges
+    long long total = 1;
+    for (const WeightedEdge& e : edges) {
+        total += e.w < 0 ? -e.w : e.w;
+    }
+    std::vector<long long> cost(best.size(), total);
+    for (std::size_t k = 0; k < best.size(); ++k) {
+        if (best[k] != 0) {
+            cost[k] = edges[best[k] - 1].w;
+        }
+    }
+
+    auto rowOf = weighted_detail::assign(n1, n2, cost);
+    WeightedMatching res;
+    res.edgeL.assign(n1 + 1, 0);
+    for (int j = 1; j <= n2; ++j) {
+        int i = rowOf[j];
+        if (i == 0) {
+            continue;
+        }
+        int e = best[static_cast<std::size_t>(i) * (n2 + 1) + j];
+        if (e == 0) {
+            return std::nullopt;
+        }
+        res.edgeL[i] = e;
+        res.weight += edges[e - 1].w;
+    }
+    return res;
+}
+
+// Maximum weight matching by the auction algorithm with epsilon scaling
+// (integer weights, edges with w <= 0 are never taken).
+// Persons are left vertices, objects are right vertices and a private object
+// u' for every left vertex u - taking it leaves u free with benefit 0. This is
+// an asymmetric assignment (objects may stay unassigned), optimal when the
+// unassigned objects are not more expensive than the assigned ones, so every
+// phase ends with reverse auction steps that bring their prices down
+// (Bertsekas, Castanon, forward/reverse auction for asymmetric assignment).
+// Benefits are scaled by n1 + 1, so the last phase with epsilon = 1 is optimal.
+// Bids of one round are computed on threads (0 - hardware concurrency), the
+// team lives for the whole run and rounds are separated by a barrier.
+inline WeightedMatching auctionMaxWeight(int n1, int n2, const std::vector<WeightedEdge>& edges, unsigned threads = 0) {
+    weighted_detail::checkEdges(n1, n2, edges);
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    const int objects = n2 + n1;
+    const long long scale = n1 + 1;
+
+    // persons 0..n1-1 are left vertices
+    // objects 0..n2-1 are right vertices, n2..n2+n1-1 private objects of left ones
+    struct Arc {
+        int object;
+        long long benefit;
+        int edge; // 0 for the private object
+    };
+    std::vector<std::size_t> offsets(n1 + 1, 0);
+    auto useful = [](const WeightedEdge& e) { return e.w > 0; };
+    for (const WeightedEdge& e : edges) {
+        if (useful(e)) {
+            offsets[e.u]++;
+        }
+    }
+    for (int p = 0; p < n1; ++p) {
+        offsets[p + 1] += offsets[p] + 1; // plus u -> u'
+    }
+    std::vector<Arc> arcs(offsets[n1]);
+    std::vector<std::size_t> pos(offsets.begin(), offsets.end() - 1);
+    long long maxBenefit = 0;
+    for (int u = 1; u <= n1; ++u) {
+        arcs[pos[u - 1]++] = {n2 + u - 1, 0, 0};
+    }
+    for (std::size_t k = 0; k < edges.size(); ++k) {
+        const WeightedEdge& e = edges[k];
+        if (!useful(e)) {
+            continue;
+        }
+        arcs[pos[e.u - 1]++] = {e.v - 1, e.w * scale, static_cast<int>(k + 1)};
+        maxBenefit = std::max(maxBenefit, e.w * scale);
+    }
+
+    // incoming arcs of every object
+    std::vector<int> arcPerson(arcs.size());
+    std::vector<std::size_t> revOffsets(objects + 1, 0), revArcs(arcs.size());
+    for (int p = 0; p < n1; ++p) {
+        for (std::size_t a = offsets[p]; a < offsets[p + 1]; ++a) {
+            arcPerson[a] = p;
+            revOffsets[arcs[a].object + 1]++;
+        }
+    }
+    for (int j = 0; j < objects; ++j) {
+        revOffsets[j + 1] += revOffsets[j];
+    }
+    std::vector<std::size_t> revPos(revOffsets.begin(), revOffsets.end() - 1);
+    for (std::size_t a = 0; a < arcs.size(); ++a) {
+        revArcs[revPos[arcs[a].object]++] = a;
+    }
+
+    std::vector<long long> price(objects, 0);
+    std::vector<int> owner(objects, -1), assignedArc(n1, -1);
+    std::vector<int> unassigned, next, bidObject(n1), touched;
+    std::vector<long long> bidValue(n1), roundBid(objects);
+    std::vector<int> roundWinner(objects, -1);
+
+    // value of the current object of an assigned person
+    auto profit = [&](int p) {
+        const Arc& a = arcs[assignedArc[p]];
+        return a.benefit - price[a.object];
+    };
+
+    // best object of person p: its arc and the bid
+    auto bid = [&](int p) {
+        long long best = std::numeric_limits<long long>::min(), second = best;
+        std::size_t bestArc = offsets[p];
+        for (std::size_t a = offsets[p]; a < offsets[p + 1]; ++a) {
+            long long value = arcs[a].benefit - price[arcs[a].object];
+            if (value > best) {
+                second = best;
+                best = value;
+                bestArc = a;
+            } else if (value > second) {
+                second = value;
+            }
+        }
+        if (second == std::numeric_limits<long long>::min()) {
+            second = best - maxBenefit; // single option, any large increment works
+        }
+        return std::pair{bestArc, best - second};
+    };
+
+    // eps shrinks by this factor between phases
+    constexpr long long EpsFactor = 16;
+    long long eps = std::max(1LL, maxBenefit / EpsFactor);
+
+    // Jacobi round: every unassigned person bids against the same prices
+    auto bidRange = [&](std::size_t from, std::size_t to) {
+        for (std::size_t k = from; k < to; ++k) {
+            int p = unassigned[k];
+            auto [a, gap] = bid(p);
+            bidObject[p] = static_cast<int>(a);
+            bidValue[p] = price[arcs[a].object] + gap + eps;
+        }
+    };
+    constexpr std::size_t MinPerThread = 4096;
+    std::atomic<std::size_t> nextBidder{0};
+    auto bidBlocks = [&] {
+        for (std::size_t from; (from = nextBidder.fetch_add(MinPerThread, std::memory_order_relaxed)) < unassigned.size(); ) {
+            bidRange(from, std::min(unassigned.size(), from + MinPerThread));
+        }
+    };
+
+    const unsigned team = static_cast<unsigned>(std::min<std::size_t>(threads, n1 / MinPerThread + 1));
+    bool done = false;
+    std::barrier sync(team);
+    std::vector<std::jthread> pool;
+    for (unsigned t = 1; t < team; ++t) {
+        pool.emplace_back([&] {
+            while (true) {
+                sync.arrive_and_wait(); // bidders of the next round are ready
+                if (done) {
+                    return;
+                }
+                bidBlocks();
+                sync.arrive_and_wait(); // round is over
+            }
+        });
+    }
+
+    while (true) {
+        // assignments that are still eps-optimal with the smaller eps stay
+        for (int p = 0; p < n1; ++p) {
+            if (int a = assignedArc[p]; a != -1) {
+                auto [best, gap] = bid(p);
+                if (profit(p) < arcs[best].benefit - price[arcs[best].object] - eps) {
+                    owner[arcs[a].object] = -1;
+                    assignedArc[p] = -1;
+                }
+            }
+        }
+        unassigned.clear();
+        for (int p = 0; p < n1; ++p) {
+            if (assignedArc[p] == -1) {
+                unassigned.push_back(p);
+            }
+        }
+
+        while (!unassigned.empty()) {
+            if (team == 1 || unassigned.size() <= MinPerThread) {
+                bidRange(0, unassigned.size());
+            } else {
+                nextBidder = 0;
+                sync.arrive_and_wait();
+                bidBlocks();
+                sync.arrive_and_wait();
+            }
+
+            // every object goes to its highest bidder, the rest bid again
+            touched.clear();
+            for (int p : unassigned) {
+                int j = arcs[bidObject[p]].object;
+                if (roundWinner[j] == -1) {
+                    touched.push_back(j);
+                    roundWinner[j] = p;
+                    roundBid[j] = bidValue[p];
+                } else if (bidValue[p] > roundBid[j]) {
+                    roundWinner[j] = p;
+                    roundBid[j] = bidValue[p];
+                }
+            }
+            next.clear();
+            for (int p : unassigned) {
+                if (roundWinner[arcs[bidObject[p]].object] != p) {
+                    next.push_back(p);
+                }
+            }
+            for (int j : touched) {
+                int p = roundWinner[j];
+                if (owner[j] != -1) {
+                    assignedArc[owner[j]] = -1;
+                    next.push_back(owner[j]);
+                }
+                owner[j] = p;
+                assignedArc[p] = bidObject[p];
+                price[j] = roundBid[j];
+                roundWinner[j] = -1;
+            }
+            unassigned.swap(next);
+        }
+
+        // reverse auction: an unassigned object pricier than lambda, the
+        // cheapest assigned one, either drops to lambda or takes its best person
+        long long lambda = std::numeric_limits<long long>::max();
+        for (int j = 0; j < objects; ++j) {
+            if (owner[j] != -1) {
+                lambda = std::min(lambda, price[j]);
+            }
+        }
+        touched.clear();
+        for (int j = 0; j < objects; ++j) {
+            if (owner[j] == -1 && price[j] > lambda) {
+                touched.push_back(j);
+            }
+        }
+        while (!touched.empty()) {
+            int j = touched.back();
+            touched.pop_back();
+            long long best = std::numeric_limits<long long>::min(), second = best;
+            std::size_t bestArc = 0;
+            for (std::size_t r = revOffsets[j]; r < revOffsets[j + 1]; ++r) {
+                std::size_t a = revArcs[r];
+                long long value = arcs[a].benefit - profit(arcPerson[a]);
+                if (value > best) {
+                    second = best;
+                    best = value;
+                    bestArc = a;
+                } else if (value > second) {
+                    second = value;
+                }
+            }
+            if (lambda >= best - eps) {
+                price[j] = lambda;
+                continue;
+            }
+            price[j] = second == std::numeric_limits<long long>::min() ? lambda : std::max(lambda, second - eps);
+            int p = arcPerson[bestArc];
+            int k = arcs[assignedArc[p]].object;
+            owner[k] = -1;
+            owner[j] = p;
+            assignedArc[p] = static_cast<int>(bestArc);
+            if (price[k] > lambda) {
+                touched.push_back(k);
+            }
+        }
+
+        if (eps == 1) {
+            break;
+        }
+        eps = std::max(1LL, eps / EpsFactor);
+    }
+    done = true;
+    sync.arrive_and_wait();
+
+    WeightedMatching res;
+    res.edgeL.assign(n1 + 1, 0);
+    for (int u = 1; u <= n1; ++u) {
+        int e = arcs[assignedArc[u - 1]].edge;
+        if (e != 0) {
+            res.edgeL[u] = e;
+            res.weight += edges[e - 1].w;
+        }
+    }
+    return res;
+}
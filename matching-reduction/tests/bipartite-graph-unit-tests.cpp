@@ -0,0 +1,304 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "bipartite_graph.hpp"
+
+using Edges = std::vector<std::pair<int, int>>;
+
+namespace {
+
+// maximum matching by trying every choice for every left vertex, small graphs only
+int bruteMatching(int n1, const Edges& edges, int u, std::vector<bool>& usedR) {
+    if (u > n1) {
+        return 0;
+    }
+    int best = bruteMatching(n1, edges, u + 1, usedR);
+    for (auto [a, b] : edges) {
+        if (a == u && !usedR[b]) {
+            usedR[b] = true;
+            best = std::max(best, 1 + bruteMatching(n1, edges, u + 1, usedR));
+            usedR[b] = false;
+        }
+    }
+    return best;
+}
+
+// matching has the given size and uses existing edges
+void checkMatching(const BipartiteGraph& g, const Edges& edges, int matching) {
+    int matched = 0;
+    for (int u = 1; u <= g.leftSize(); ++u) {
+        int v = g.matchL(u);
+        if (v == 0) {
+            EXPECT_EQ(g.matchedEdge(u), 0);
+            continue;
+        }
+        matched++;
+        EXPECT_EQ(g.matchR(v), u);
+        auto [a, b] = edges[g.matchedEdge(u) - 1];
+        EXPECT_EQ(a, u);
+        EXPECT_EQ(b, v);
+    }
+    EXPECT_EQ(matched, matching);
+}
+
+// matching is consistent, cover covers every edge and has the size of the matching
+void checkMatchingAndCover(BipartiteGraph& g, const Edges& edges, int matching) {
+    checkMatching(g, edges, matching);
+
+    g.buildCover();
+    int cover = 0;
+    for (int u = 1; u <= g.leftSize(); ++u) {
+        cover += g.inCoverL(u);
+    }
+    for (int v = 1; v <= g.rightSize(); ++v) {
+        cover += g.inCoverR(v);
+    }
+    EXPECT_EQ(cover, matching);
+    for (auto [u, v] : edges) {
+        EXPECT_TRUE(g.inCoverL(u) || g.inCoverR(v));
+    }
+}
+
+} // namespace
+
+TEST(BipartiteGraph, csr_keeps_input_order) {
+    Edges edges = {{2, 1}, {1, 3}, {2, 2}, {1, 1}};
+    BipartiteGraph g(2, 3, edges);
+
+    EXPECT_EQ(g.edgeCount(), 4);
+    auto a1 = g.adj(1);
+    ASSERT_EQ(a1.size(), 2);
+    EXPECT_EQ(a1[0].v, 3);
+    EXPECT_EQ(a1[0].idx, 2);
+    EXPECT_EQ(a1[1].v, 1);
+    EXPECT_EQ(a1[1].idx, 4);
+    auto a2 = g.adj(2);
+    ASSERT_EQ(a2.size(), 2);
+    EXPECT_EQ(a2[0].idx, 1);
+    EXPECT_EQ(a2[1].idx, 3);
+}
+
+TEST(BipartiteGraph, bad_endpoint_throws) {
+    EXPECT_THROW(BipartiteGraph(2, 2, {{3, 1}}), std::out_of_range);
+    EXPECT_THROW(BipartiteGraph(2, 2, {{1, 0}}), std::out_of_range);
+}
+
+TEST(BipartiteGraph, empty_graph) {
+    BipartiteGraph g(3, 2, {});
+    EXPECT_EQ(g.maxMatchingHopcroftKarp(), 0);
+    checkMatchingAndCover(g, {}, 0);
+}
+
+TEST(BipartiteGraph, needs_augmenting_path) {
+    // greedy would match 1-1 and leave 2 unmatched
+    Edges edges = {{1, 1}, {1, 2}, {2, 1}};
+    BipartiteGraph g(2, 2, edges);
+    EXPECT_EQ(g.maxMatchingKuhn(), 2);
+    checkMatchingAndCover(g, edges, 2);
+    EXPECT_EQ(g.maxMatchingHopcroftKarp(), 2);
+    checkMatchingAndCover(g, edges, 2);
+}
+
+TEST(BipartiteGraph, random_against_brute_force) {
+    std::mt19937 gen(41);
+    for (int iter = 0; iter < 300; ++iter) {
+        int n1 = gen() % 7 + 1;
+        int n2 = gen() % 7 + 1;
+        int m = gen() % 16;
+        Edges edges(m);
+        for (auto& [u, v] : edges) {
+            u = gen() % n1 + 1;
+            v = gen() % n2 + 1;
+        }
+
+        std::vector<bool> usedR(n2 + 1);
+        int expected = bruteMatching(n1, edges, 1, usedR);
+
+        BipartiteGraph g(n1, n2, edges);
+        int kuhn = g.maxMatchingKuhn();
+        EXPECT_EQ(kuhn, expected);
+        checkMatchingAndCover(g, edges, kuhn);
+
+        int hk = g.maxMatchingHopcroftKarp();
+        EXPECT_EQ(hk, expected);
+        checkMatchingAndCover(g, edges, hk);
+    }
+}
+
+TEST(BipartiteGraph, deep_augmenting_path) {
+    // left u < n first takes right u, the last left vertex then needs
+    // a path through all of them: n -> 1 -> 2 -> ... -> n
+    const int n = 200000;
+    Edges edges;
+    for (int u = 1; u < n; ++u) {
+        edges.push_back({u, u});
+        edges.push_back({u, u + 1});
+    }
+    edges.push_back({n, 1});
+
+    BipartiteGraph g(n, n, edges);
+    EXPECT_EQ(g.maxMatchingKuhn(), n);
+    EXPECT_EQ(g.maxMatchingHopcroftKarp(), n);
+    checkMatchingAndCover(g, edges, n);
+}
+
+TEST(BipartiteGraph, initial_strategies_then_augment) {
+    using S = BipartiteGraph::InitStrategy;
+    std::mt19937 gen(42);
+    for (int iter = 0; iter < 300; ++iter) {
+        int n1 = gen() % 7 + 1;
+        int n2 = gen() % 7 + 1;
+        int m = gen() % 16;
+        Edges edges(m);
+        for (auto& [u, v] : edges) {
+            u = gen() % n1 + 1;
+            v = gen() % n2 + 1;
+        }
+        std::vector<bool> usedR(n2 + 1);
+        int expected = bruteMatching(n1, edges, 1, usedR);
+
+        BipartiteGraph g(n1, n2, edges);
+        for (S s : {S::None, S::Greedy, S::DegreeOne, S::KarpSipser}) {
+            int initial = g.initialMatching(s);
+            EXPECT_LE(initial, expected);
+            EXPECT_EQ(g.matchingSize(), initial);
+            checkMatching(g, edges, initial);
+
+            g.initialMatching(s);
+            EXPECT_EQ(g.maxMatchingKuhn(), expected);
+            g.initialMatching(s);
+            EXPECT_EQ(g.maxMatchingHopcroftKarp(), expected);
+            checkMatchingAndCover(g, edges, expected);
+        }
+    }
+}
+
+TEST(BipartiteGraph, karp_sipser_is_optimal_on_forests) {
+    // only degree-1 steps are taken on a forest, and they never lose optimality
+    std::mt19937 gen(43);
+    for (int iter = 0; iter < 200; ++iter) {
+        int n1 = gen() % 6 + 1;
+        int n2 = gen() % 6 + 1;
+        // random spanning forest: every vertex but the first joins an earlier one
+        Edges edges;
+        std::vector<int> order;
+        for (int x = 1; x <= n1 + n2; ++x) {
+            order.push_back(x);
+        }
+        std::shuffle(order.begin(), order.end(), gen);
+        for (size_t i = 1; i < order.size(); ++i) {
+            int x = order[i];
+            int y = order[gen() % i];
+            if ((x <= n1) != (y <= n1) && gen() % 4 != 0) {
+                int u = std::min(x, y);
+                int v = std::max(x, y) - n1;
+                edges.push_back({u, v});
+            }
+        }
+        std::vector<bool> usedR(n2 + 1);
+        int expected = bruteMatching(n1, edges, 1, usedR);
+
+        BipartiteGraph g(n1, n2, edges);
+        EXPECT_EQ(g.initialMatching(BipartiteGraph::InitStrategy::KarpSipser), expected);
+    }
+}
+
+TEST(BipartiteGraph, pothen_fan_against_brute_force) {
+    std::mt19937 gen(43);
+    for (int iter = 0; iter < 300; ++iter) {
+        int n1 = gen() % 7 + 1;
+        int n2 = gen() % 7 + 1;
+        int m = gen() % 16;
+        Edges edges(m);
+        for (auto& [u, v] : edges) {
+            u = gen() % n1 + 1;
+            v = gen() % n2 + 1;
+        }
+        std::vector<bool> usedR(n2 + 1);
+        int expected = bruteMatching(n1, edges, 1, usedR);
+
+        BipartiteGraph g(n1, n2, edges);
+        for (unsigned threads : {1u, 3u}) {
+            g.resetMatching();
+            EXPECT_EQ(g.maxMatchingPothenFan(threads), expected);
+            checkMatchingAndCover(g, edges, expected);
+        }
+    }
+}
+
+TEST(BipartiteGraph, pothen_fan_large_random) {
+    std::mt19937 gen(44);
+    const int n = 20000;
+    Edges edges(3 * n);
+    for (auto& [u, v] : edges) {
+        u = gen() % n + 1;
+        v = gen() % n + 1;
+    }
+
+    BipartiteGraph g(n, n, edges);
+    int expected = g.maxMatchingHopcroftKarp();
+    for (unsigned threads : {1u, 4u}) {
+        g.resetMatching();
+        EXPECT_EQ(g.maxMatchingPothenFan(threads), expected);
+        checkMatchingAndCover(g, edges, expected);
+
+        g.initialMatching(BipartiteGraph::InitStrategy::Greedy);
+        EXPECT_EQ(g.maxMatchingPothenFan(threads), expected);
+    }
+}
+
+TEST(BipartiteGraph, pothen_fan_deep_augmenting_path) {
+    const int n = 200000;
+    Edges edges;
+    for (int u = 1; u < n; ++u) {
+        edges.push_back({u, u});
+        edges.push_back({u, u + 1});
+    }
+    edges.push_back({n, 1});
+
+    BipartiteGraph g(n, n, edges);
+    EXPECT_EQ(g.maxMatchingPothenFan(2), n);
+    checkMatchingAndCover(g, edges, n);
+}
+
+TEST(BipartiteGraph, dinic_against_brute_force) {
+    using S = BipartiteGraph::InitStrategy;
+    std::mt19937 gen(47);
+    for (int iter = 0; iter < 300; ++iter) {
+        int n1 = gen() % 7 + 1;
+        int n2 = gen() % 7 + 1;
+        int m = gen() % 16;
+        Edges edges(m);
+        for (auto& [u, v] : edges) {
+            u = gen() % n1 + 1;
+            v = gen() % n2 + 1;
+        }
+        std::vector<bool> usedR(n2 + 1);
+        int expected = bruteMatching(n1, edges, 1, usedR);
+
+        BipartiteGraph g(n1, n2, edges);
+        for (S s : {S::None, S::Greedy}) {
+            g.initialMatching(s);
+            EXPECT_EQ(g.maxMatchingDinic(), expected);
+            checkMatchingAndCover(g, edges, expected);
+        }
+    }
+}
+
+TEST(BipartiteGraph, dinic_deep_augmenting_path) {
+    const int n = 200000;
+    Edges edges;
+    for (int u = 1; u < n; ++u) {
+        edges.push_back({u, u});
+        edges.push_back({u, u + 1});
+    }
+    edges.push_back({n, 1});
+
+    BipartiteGraph g(n, n, edges);
+    g.initialMatching(BipartiteGraph::InitStrategy::Greedy);
+    EXPECT_EQ(g.maxMatchingDinic(), n);
+    checkMatchingAndCover(g, edges, n);
+}
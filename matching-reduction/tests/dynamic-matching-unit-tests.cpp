@@ -0,0 +1,204 @@
+#include <gtest/gtest.h>
+#include <random>
+#include <set>
+#include <utility>
+#include <vector>
+
+#include "bipartite_graph.hpp"
+#include "dynamic_matching.hpp"
+
+using Edges = std::vector<std::pair<int, int>>;
+
+namespace {
+
+// live edges by number, {0, 0} for removed ones
+struct Mirror {
+    Edges edges{{0, 0}};
+
+    Edges live() const {
+        Edges res;
+        for (auto e : edges) {
+            if (e.first != 0) {
+                res.push_back(e);
+            }
+        }
+        return res;
+    }
+};
+
+int maximum(int n1, int n2, const Edges& edges) {
+    BipartiteGraph g(n1, n2, edges);
+    return g.maxMatchingHopcroftKarp();
+}
+
+// matching uses live edges, cover has its size and covers every live edge
+void check(const DynamicMatching& dm, const Mirror& mirror) {
+    Edges live = mirror.live();
+    ASSERT_EQ(dm.matchingSize(), maximum(dm.leftSize(), dm.rightSize(), live));
+
+    int matched = 0;
+    long long weight = 0;
+    for (int u = 1; u <= dm.leftSize(); ++u) {
+        if (dm.matchL(u) == 0) {
+            continue;
+        }
+        matched++;
+        int e = dm.matchedEdge(u);
+        weight += e;
+        EXPECT_EQ(mirror.edges[e], std::make_pair(u, dm.matchL(u)));
+        EXPECT_EQ(dm.matchR(dm.matchL(u)), u);
+    }
+    EXPECT_EQ(matched, dm.matchingSize());
+    EXPECT_EQ(weight, dm.matchingWeight());
+
+    int cover = 0, firstL = 0, firstR = 0;
+    for (int u = 1; u <= dm.leftSize(); ++u) {
+        cover += dm.inCoverL(u);
+        if (firstL == 0 && dm.inCoverL(u)) {
+            firstL = u;
+        }
+    }
+    for (int v = 1; v <= dm.rightSize(); ++v) {
+        cover += dm.inCoverR(v);
+        if (firstR == 0 && dm.inCoverR(v)) {
+            firstR = v;
+        }
+    }
+    EXPECT_EQ(cover, dm.matchingSize());
+    EXPECT_EQ(dm.firstCoverL(), firstL);
+    EXPECT_EQ(dm.firstCoverR(), firstR);
+    for (auto [u, v] : live) {
+        EXPECT_TRUE(dm.inCoverL(u) || dm.inCoverR(v));
+    }
+}
+
+} // namespace
+
+TEST(DynamicMatching, index_set) {
+    std::mt19937 gen(45);
+    for (std::size_t n : {0, 1, 63, 64, 65, 4096, 5000}) {
+        for (bool full : {false, true}) {
+            IndexSet s;
+            s.assign(n, full);
+            std::set<std::size_t> ref;
+            for (std::size_t x = 0; full && x < n; ++x) {
+                ref.insert(x);
+            }
+            for (int step = 0; step < 2000 && n > 0; ++step) {
+                std::size_t x = gen() % n;
+                if (gen() % 2) {
+                    s.insert(x);
+                    ref.insert(x);
+                } else {
+                    s.erase(x);
+                    ref.erase(x);
+                }
+                ASSERT_EQ(s.first(), ref.empty() ? IndexSet::npos : *ref.begin());
+            }
+            EXPECT_EQ(s.first(), ref.empty() ? IndexSet::npos : *ref.begin());
+        }
+    }
+}
+
+TEST(DynamicMatching, insert_then_delete) {
+    DynamicMatching dm(2, 2);
+    Mirror mirror;
+    EXPECT_EQ(dm.matchingSize(), 0);
+
+    mirror.edges.push_back({1, 1});
+    EXPECT_EQ(dm.addEdge(1, 1), 1);
+    EXPECT_EQ(dm.matchingSize(), 1);
+
+    mirror.edges.push_back({2, 1});
+    EXPECT_EQ(dm.addEdge(2, 1), 2);
+    EXPECT_EQ(dm.matchingSize(), 1);
+    check(dm, mirror);
+
+    // augmenting path 2 -> 1 -> 1 -> 2
+    mirror.edges.push_back({1, 2});
+    dm.addEdge(1, 2);
+    EXPECT_EQ(dm.matchingSize(), 2);
+    check(dm, mirror);
+
+    EXPECT_TRUE(dm.removeEdge(1));
+    mirror.edges[1] = {0, 0};
+    EXPECT_FALSE(dm.removeEdge(1));
+    EXPECT_FALSE(dm.removeEdge(7));
+    check(dm, mirror);
+}
+
+TEST(DynamicMatching, random_updates) {
+    std::mt19937 gen(45);
+    for (int iter = 0; iter < 30; ++iter) {
+        int n1 = gen() % 12 + 1;
+        int n2 = gen() % 12 + 1;
+        Mirror mirror;
+        Edges initial(gen() % 20);
+        for (auto& [u, v] : initial) {
+            u = gen() % n1 + 1;
+            v = gen() % n2 + 1;
+            mirror.edges.push_back({u, v});
+        }
+
+        DynamicMatching dm(n1, n2, initial);
+        check(dm, mirror);
+        for (int step = 0; step < 200; ++step) {
+            if (gen() % 2 == 0) {
+                int u = gen() % n1 + 1;
+                int v = gen() % n2 + 1;
+                EXPECT_EQ(dm.addEdge(u, v), (int)mirror.edges.size());
+                mirror.edges.push_back({u, v});
+            } else {
+                int e = gen() % mirror.edges.size();
+                bool alive = e != 0 && mirror.edges[e].first != 0;
+                EXPECT_EQ(dm.removeEdge(e), alive);
+                if (alive) {
+                    mirror.edges[e] = {0, 0};
+                }
+            }
+            check(dm, mirror);
+        }
+    }
+}
+
+TEST(DynamicMatching, removing_cover_vertex_decreases_matching) {
+    std::mt19937 gen(46);
+    const int n = 30;
+    Mirror mirror;
+    Edges initial(80);
+    for (auto& [u, v] : initial) {
+        u = gen() % n + 1;
+        v = gen() % n + 1;
+        mirror.edges.push_back({u, v});
+    }
+    DynamicMatching dm(n, n, initial);
+
+    while (dm.matchingSize() != 0) {
+        int size = dm.matchingSize();
+        int u = 1;
+        while (u <= n && !dm.inCoverL(u)) {
+            ++u;
+        }
+        if (u <= n) {
+            dm.removeVertexL(u);
+            for (auto& e : mirror.edges) {
+                if (e.first == u) {
+                    e = {0, 0};
+                }
+            }
+        } else {
+            int v = 1;
+            while (!dm.inCoverR(v)) {
+                ++v;
+            }
+            dm.removeVertexR(v);
+            for (auto& e : mirror.edges) {
+                if (e.second == v) {
+                    e = {0, 0};
+                }
+            }
+        }
+        EXPECT_EQ(dm.matchingSize(), size - 1);
+        check(dm, mirror);
+    }
+}
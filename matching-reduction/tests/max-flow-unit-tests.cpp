@@ -0,0 +1,261 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "b_matching.hpp"
+#include "max_flow.hpp"
+
+namespace {
+
+struct TestEdge {
+    int from, to;
+    long long cap;
+};
+
+// minimum s-t cut by trying every vertex set with s and without t, small graphs only
+long long bruteMinCut(int n, const std::vector<TestEdge>& edges, int s, int t) {
+    long long best = MaxFlow::Inf;
+    for (unsigned mask = 0; mask < (1u << n); ++mask) {
+        if (!(mask >> s & 1) || (mask >> t & 1)) {
+            continue;
+        }
+        long long cut = 0;
+        for (const TestEdge& e : edges) {
+            if ((mask >> e.from & 1) && !(mask >> e.to & 1)) {
+                cut = std::min(cut + e.cap, MaxFlow::Inf); // both are at most Inf
+            }
+        }
+        best = std::min(best, cut);
+    }
+    return best;
+}
+
+std::vector<TestEdge> randomNetwork(std::mt19937& gen, int n, int m) {
+    std::vector<TestEdge> edges(m);
+    for (auto& e : edges) {
+        e.from = gen() % n;
+        e.to = gen() % n;
+        e.cap = gen() % 10;
+    }
+    return edges;
+}
+
+// flow respects capacities, is conserved and has the given value
+void checkFlow(const MaxFlow& net, const std::vector<TestEdge>& edges, int s, int t, long long value) {
+    std::vector<long long> excess(net.vertexCount(), 0);
+    for (std::size_t e = 0; e < edges.size(); ++e) {
+        long long f = net.flow(e);
+        EXPECT_GE(f, 0);
+        EXPECT_LE(f, edges[e].cap);
+        excess[edges[e].from] -= f;
+        excess[edges[e].to] += f;
+    }
+    for (int x = 0; x < net.vertexCount(); ++x) {
+        if (x != s && x != t) {
+            EXPECT_EQ(excess[x], 0);
+        }
+    }
+    EXPECT_EQ(excess[t], value);
+}
+
+} // namespace
+
+TEST(MaxFlow, textbook_network) {
+    // CLRS 26.1: the maximum flow is 23
+    std::vector<TestEdge> edges = {{0, 1, 16}, {0, 2, 13}, {2, 1, 4},  {1, 3, 12}, {3, 2, 9},
+                                   {2, 4, 14}, {4, 3, 7},  {3, 5, 20}, {4, 5, 4}};
+    MaxFlow net(6);
+    for (const TestEdge& e : edges) {
+        net.addEdge(e.from, e.to, e.cap);
+    }
+    EXPECT_EQ(net.maxFlow(0, 5), 23);
+    checkFlow(net, edges, 0, 5, 23);
+
+    long long cut = 0;
+    for (int e : net.cutEdges()) {
+        cut += edges[e].cap;
+    }
+    EXPECT_EQ(cut, 23);
+    EXPECT_TRUE(net.onSourceSide(0));
+    EXPECT_FALSE(net.onSourceSide(5));
+}
+
+TEST(MaxFlow, bad_arguments_throw) {
+    MaxFlow net(3);
+    EXPECT_THROW(net.addEdge(0, 3, 1), std::out_of_range);
+    EXPECT_THROW(net.addEdge(0, 1, 1, 2), std::invalid_argument);
+    EXPECT_THROW(net.maxFlow(1, 1), std::invalid_argument);
+    net.addEdge(0, 1, 1);
+    net.maxFlow(0, 1);
+    EXPECT_THROW(net.addEdge(1, 2, 1), std::logic_error);
+    EXPECT_THROW(net.setVertexCapacity(1, 1), std::logic_error);
+}
+
+TEST(MaxFlow, random_against_brute_force_cut) {
+    std::mt19937 gen(48);
+    for (int iter = 0; iter < 500; ++iter) {
+        int n = gen() % 7 + 2;
+        auto edges = randomNetwork(gen, n, gen() % 20);
+        int s = gen() % n;
+        int t = (s + 1 + gen() % (n - 1)) % n;
+
+        MaxFlow net(n);
+        for (const TestEdge& e : edges) {
+            net.addEdge(e.from, e.to, e.cap);
+        }
+        long long expected = bruteMinCut(n, edges, s, t);
+        long long value = net.maxFlow(s, t);
+        EXPECT_EQ(value, expected);
+        checkFlow(net, edges, s, t, value);
+
+        long long cut = 0;
+        for (int e : net.cutEdges()) {
+            cut += edges[e].cap;
+        }
+        EXPECT_EQ(cut, value);
+    }
+}
+
+TEST(MaxFlow, vertex_capacities_match_explicit_split) {
+    std::mt19937 gen(49);
+    for (int iter = 0; iter < 300; ++iter) {
+        int n = gen() % 6 + 2;
+        auto edges = randomNetwork(gen, n, gen() % 16);
+        std::vector<long long> vcap(n);
+        for (auto& c : vcap) {
+            c = gen() % 3 == 0 ? MaxFlow::Inf : gen() % 8;
+        }
+
+        // x -> x + n with the capacity of x, edges leave from x + n
+        std::vector<TestEdge> split;
+        for (const TestEdge& e : edges) {
+            split.push_back({e.from + n, e.to, e.cap});
+        }
+        for (int x = 0; x < n; ++x) {
+            split.push_back({x, x + n, vcap[x]});
+        }
+
+        MaxFlow net(n);
+        for (const TestEdge& e : edges) {
+            net.addEdge(e.from, e.to, e.cap);
+        }
+        for (int x = 1; x + 1 < n; ++x) {
+            net.setVertexCapacity(x, vcap[x]);
+        }
+        vcap[0] = vcap[n - 1] = MaxFlow::Inf;
+        split[edges.size()].cap = split[edges.size() + n - 1].cap = MaxFlow::Inf;
+
+        long long value = net.maxFlow(0, n - 1);
+        EXPECT_EQ(value, bruteMinCut(2 * n, split, 0, n - 1));
+
+        long long cut = 0;
+        for (int e : net.cutEdges()) {
+            cut += edges[e].cap;
+        }
+        for (int x = 1; x + 1 < n; ++x) {
+            if (net.vertexInCut(x)) {
+                cut += vcap[x];
+            }
+        }
+        EXPECT_EQ(cut, value);
+    }
+}
+
+TEST(MaxFlow, initial_flow_is_augmented) {
+    // 0 -> 1 -> 3 carries 1 already, 0 -> 2 -> 3 is free
+    MaxFlow net(4);
+    int a = net.addEdge(0, 1, 2, 1);
+    net.addEdge(1, 3, 1, 1);
+    net.addEdge(0, 2, 1);
+    net.addEdge(2, 3, 1);
+    EXPECT_EQ(net.maxFlow(0, 3), 2);
+    EXPECT_EQ(net.flow(a), 1);
+}
+
+TEST(BMatching, unit_capacities_give_konig_cover) {
+    std::mt19937 gen(50);
+    for (int iter = 0; iter < 200; ++iter) {
+        int n1 = gen() % 7 + 1;
+        int n2 = gen() % 7 + 1;
+        std::vector<std::pair<int, int>> edges(gen() % 16);
+        for (auto& [u, v] : edges) {
+            u = gen() % n1 + 1;
+            v = gen() % n2 + 1;
+        }
+        BipartiteGraph g(n1, n2, edges);
+        int matching = g.maxMatchingHopcroftKarp();
+
+        auto res = maxBMatching(g, std::vector<long long>(n1 + 1, 1), std::vector<long long>(n2 + 1, 1), MaxFlow::Inf);
+        EXPECT_EQ(res.size, matching);
+        EXPECT_TRUE(res.cutEdges.empty());
+        int cover = std::count(res.cutL.begin(), res.cutL.end(), 1) + std::count(res.cutR.begin(), res.cutR.end(), 1);
+        EXPECT_EQ(cover, matching);
+        for (auto [u, v] : edges) {
+            EXPECT_TRUE(res.cutL[u] || res.cutR[v]);
+        }
+    }
+}
+
+TEST(BMatching, random_against_brute_force) {
+    std::mt19937 gen(51);
+    for (int iter = 0; iter < 300; ++iter) {
+        int n1 = gen() % 4 + 1;
+        int n2 = gen() % 4 + 1;
+        std::vector<std::pair<int, int>> edges(gen() % 11);
+        for (auto& [u, v] : edges) {
+            u = gen() % n1 + 1;
+            v = gen() % n2 + 1;
+        }
+        std::vector<long long> capL(n1 + 1), capR(n2 + 1);
+        for (int u = 1; u <= n1; ++u) {
+            capL[u] = gen() % 3;
+        }
+        for (int v = 1; v <= n2; ++v) {
+            capR[v] = gen() % 3;
+        }
+
+        // every subset of edges within the vertex capacities
+        long long expected = 0;
+        for (unsigned mask = 0; mask < (1u << edges.size()); ++mask) {
+            std::vector<long long> degL(n1 + 1), degR(n2 + 1);
+            bool fits = true;
+            for (std::size_t e = 0; e < edges.size(); ++e) {
+                if (mask >> e & 1) {
+                    fits = fits && ++degL[edges[e].first] <= capL[edges[e].first] &&
+                           ++degR[edges[e].second] <= capR[edges[e].second];
+                }
+            }
+            if (fits) {
+                expected = std::max<long long>(expected, __builtin_popcount(mask));
+            }
+        }
+
+        BipartiteGraph g(n1, n2, edges);
+        auto res = maxBMatching(g, capL, capR);
+        EXPECT_EQ(res.size, expected);
+
+        std::vector<long long> degL(n1 + 1), degR(n2 + 1);
+        for (std::size_t e = 1; e <= edges.size(); ++e) {
+            EXPECT_LE(res.edgeFlow[e], 1);
+            degL[edges[e - 1].first] += res.edgeFlow[e];
+            degR[edges[e - 1].second] += res.edgeFlow[e];
+        }
+        for (int u = 1; u <= n1; ++u) {
+            EXPECT_LE(degL[u], capL[u]);
+        }
+        for (int v = 1; v <= n2; ++v) {
+            EXPECT_LE(degR[v], capR[v]);
+        }
+
+        long long cut = static_cast<long long>(res.cutEdges.size());
+        for (int u = 1; u <= n1; ++u) {
+            cut += res.cutL[u] ? capL[u] : 0;
+        }
+        for (int v = 1; v <= n2; ++v) {
+            cut += res.cutR[v] ? capR[v] : 0;
+        }
+        EXPECT_EQ(cut, res.size);
+    }
+}
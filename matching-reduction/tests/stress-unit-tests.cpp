@@ -0,0 +1,249 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "bipartite_graph.hpp"
+#include "instance_generator.hpp"
+
+namespace {
+
+// maximum matching by dp over subsets of used right vertices, n2 <= 12 only
+int bruteMatching(const Instance& inst) {
+    std::vector<std::vector<int>> adj(inst.n1 + 1);
+    for (auto [u, v] : inst.edges) {
+        adj[u].push_back(v - 1);
+    }
+    // best[mask] - largest matching of the left vertices so far using exactly mask
+    std::vector<int> best(1u << inst.n2, -1), next;
+    best[0] = 0;
+    for (int u = 1; u <= inst.n1; ++u) {
+        next = best;
+        for (unsigned mask = 0; mask < best.size(); ++mask) {
+            if (best[mask] < 0) {
+                continue;
+            }
+            for (int v : adj[u]) {
+                if (!(mask >> v & 1)) {
+                    next[mask | 1u << v] = std::max(next[mask | 1u << v], best[mask] + 1);
+                }
+            }
+        }
+        best.swap(next);
+    }
+    return *std::max_element(best.begin(), best.end());
+}
+
+// matching of the expected size, cover of the same size that covers every edge
+void checkMatchingAndCover(BipartiteGraph& g, const Instance& inst, int expected) {
+    int matched = 0;
+    for (int u = 1; u <= inst.n1; ++u) {
+        if (int v = g.matchL(u); v != 0) {
+            matched++;
+            ASSERT_EQ(g.matchR(v), u);
+            auto [a, b] = inst.edges[g.matchedEdge(u) - 1];
+            EXPECT_EQ(a, u);
+            EXPECT_EQ(b, v);
+        }
+    }
+    EXPECT_EQ(matched, expected);
+
+    g.buildCover();
+    int cover = 0;
+    for (int u = 1; u <= inst.n1; ++u) {
+        cover += g.inCoverL(u);
+    }
+    for (int v = 1; v <= inst.n2; ++v) {
+        cover += g.inCoverR(v);
+    }
+    EXPECT_EQ(cover, expected);
+    for (auto [u, v] : inst.edges) {
+        EXPECT_TRUE(g.inCoverL(u) || g.inCoverR(v));
+    }
+}
+
+// Cover vertices and their matched edges in the order main prints them
+// (left vertices, then right ones as negative numbers)
+using Answers = std::pair<std::vector<int>, std::vector<int>>;
+
+// the original solution: recursive Kuhn over adjacency in input order, cover by
+// dfs from free left vertices, the matched edge is the first copy in input order
+Answers baselineAnswers(const Instance& inst) {
+    std::vector<std::vector<std::pair<int, int>>> adj(inst.n1 + 1);
+    for (int i = 0; i < static_cast<int>(inst.edges.size()); ++i) {
+        adj[inst.edges[i].first].emplace_back(inst.edges[i].second, i + 1);
+    }
+    std::vector<int> matchL(inst.n1 + 1), matchR(inst.n2 + 1);
+    std::vector<bool> visited, visL(inst.n1 + 1), visR(inst.n2 + 1);
+
+    auto dfs = [&](auto& self, int u) -> bool {
+        if (visited[u]) return false;
+        visited[u] = true;
+        for (auto [v, idx] : adj[u]) {
+            if (matchR[v] == 0 || self(self, matchR[v])) {
+                matchL[u] = v;
+                matchR[v] = u;
+                return true;
+            }
+        }
+        return false;
+    };
+    for (int u = 1; u <= inst.n1; ++u) {
+        visited.assign(inst.n1 + 1, false);
+        dfs(dfs, u);
+    }
+
+    auto dfsCover = [&](auto& self, int u) -> void {
+        visL[u] = true;
+        for (auto [v, idx] : adj[u]) {
+            if (matchL[u] == v) continue;
+            if (!visR[v]) {
+                visR[v] = true;
+                if (matchR[v] && !visL[matchR[v]]) self(self, matchR[v]);
+            }
+        }
+    };
+    for (int u = 1; u <= inst.n1; ++u) {
+        if (matchL[u] == 0) dfsCover(dfsCover, u);
+    }
+
+    auto firstEdge = [&](int u, int v) {
+        for (auto [w, idx] : adj[u]) {
+            if (w == v) return idx;
+        }
+        return 0;
+    };
+    Answers res;
+    for (int u = 1; u <= inst.n1; ++u) {
+        if (!visL[u]) {
+            res.first.push_back(u);
+            res.second.push_back(firstEdge(u, matchL[u]));
+        }
+    }
+    for (int v = 1; v <= inst.n2; ++v) {
+        if (visR[v]) {
+            res.first.push_back(-v);
+            res.second.push_back(firstEdge(matchR[v], v));
+        }
+    }
+    return res;
+}
+
+Answers graphAnswers(BipartiteGraph& g) {
+    g.buildCover();
+    Answers res;
+    for (int u = 1; u <= g.leftSize(); ++u) {
+        if (g.inCoverL(u)) {
+            res.first.push_back(u);
+            res.second.push_back(g.matchedEdge(u));
+        }
+    }
+    for (int v = 1; v <= g.rightSize(); ++v) {
+        if (g.inCoverR(v)) {
+            res.first.push_back(-v);
+            res.second.push_back(g.matchedEdge(g.matchR(v)));
+        }
+    }
+    return res;
+}
+
+} // namespace
+
+TEST(InstanceGenerator, same_seed_same_instance) {
+    for (auto kind : {InstanceKind::Random, InstanceKind::PowerLaw, InstanceKind::KuhnWorstCase}) {
+        auto a = generateInstance(kind, 50, 40, 200, 7);
+        auto b = generateInstance(kind, 50, 40, 200, 7);
+        EXPECT_EQ(a.edges, b.edges);
+        for (auto [u, v] : a.edges) {
+            EXPECT_TRUE(u >= 1 && u <= 50 && v >= 1 && v <= 40);
+        }
+    }
+    EXPECT_NE(generateInstance(InstanceKind::Random, 50, 40, 200, 7).edges,
+              generateInstance(InstanceKind::Random, 50, 40, 200, 8).edges);
+    EXPECT_EQ(generateInstance(InstanceKind::KuhnWorstCase, 50, 40, 0, 1).edges.size(), 79);
+}
+
+TEST(InstanceGenerator, power_law_has_hubs) {
+    auto inst = generateInstance(InstanceKind::PowerLaw, 1000, 1000, 20000, 3);
+    std::vector<int> deg(1001);
+    for (auto [u, v] : inst.edges) {
+        deg[u]++;
+    }
+    // the top rank gets ~ 1 / H(1000) ~ 13% of the edges, uniform would give 20
+    EXPECT_GT(*std::max_element(deg.begin(), deg.end()), 1000);
+}
+
+// every engine from every initial matching against brute force on all instance kinds
+TEST(Stress, engines_against_brute_force) {
+    using S = BipartiteGraph::InitStrategy;
+    for (std::uint64_t seed = 1; seed <= 150; ++seed) {
+        for (auto kind : {InstanceKind::Random, InstanceKind::PowerLaw, InstanceKind::KuhnWorstCase}) {
+            int n1 = static_cast<int>(seed % 10) + 1;
+            int n2 = static_cast<int>(seed * 7 % 10) + 1;
+            int m = static_cast<int>(seed * 13 % 25);
+            Instance inst = generateInstance(kind, n1, n2, m, seed);
+            int expected = bruteMatching(inst);
+
+            BipartiteGraph g(inst.n1, inst.n2, inst.edges);
+            for (S init : {S::None, S::KarpSipser}) {
+                g.initialMatching(init);
+                EXPECT_EQ(g.maxMatchingHopcroftKarp(), expected);
+                checkMatchingAndCover(g, inst, expected);
+                g.initialMatching(init);
+                EXPECT_EQ(g.maxMatchingKuhn(), expected);
+                checkMatchingAndCover(g, inst, expected);
+                g.initialMatching(init);
+                EXPECT_EQ(g.maxMatchingPothenFan(2), expected);
+                checkMatchingAndCover(g, inst, expected);
+                g.initialMatching(init);
+                EXPECT_EQ(g.maxMatchingDinic(), expected);
+                checkMatchingAndCover(g, inst, expected);
+            }
+        }
+    }
+}
+
+// the default of main (Kuhn from the empty matching) answers exactly as the
+// original solution did, parallel edges included
+TEST(Stress, default_engine_matches_original_answers) {
+    for (std::uint64_t seed = 1; seed <= 100; ++seed) {
+        for (auto kind : {InstanceKind::Random, InstanceKind::PowerLaw, InstanceKind::KuhnWorstCase}) {
+            int n = static_cast<int>(seed % 50) + 1;
+            Instance inst = generateInstance(kind, n, n + static_cast<int>(seed % 7), 3 * n, seed);
+            BipartiteGraph g(inst.n1, inst.n2, inst.edges);
+            g.maxMatchingKuhn();
+            EXPECT_EQ(graphAnswers(g), baselineAnswers(inst)) << "seed " << seed;
+        }
+    }
+}
+
+// whichever parallel copy the engine matched, the first one is reported
+TEST(Stress, matched_edge_is_first_parallel_copy) {
+    for (std::uint64_t seed = 1; seed <= 50; ++seed) {
+        Instance inst = generateInstance(InstanceKind::PowerLaw, 30, 30, 150, seed);
+        BipartiteGraph g(inst.n1, inst.n2, inst.edges);
+        g.initialMatching(BipartiteGraph::InitStrategy::KarpSipser);
+        g.maxMatchingHopcroftKarp();
+        for (int u = 1; u <= inst.n1; ++u) {
+            if (int e = g.matchedEdge(u); e != 0) {
+                auto first = std::find(inst.edges.begin(), inst.edges.end(), std::pair{u, g.matchL(u)});
+                EXPECT_EQ(e, first - inst.edges.begin() + 1);
+            }
+        }
+    }
+}
+
+TEST(Stress, max_size_instances) {
+    // the judge limits: n1, n2, m <= 200000
+    const int n = 200000;
+    for (auto kind : {InstanceKind::Random, InstanceKind::PowerLaw, InstanceKind::KuhnWorstCase}) {
+        Instance inst = generateInstance(kind, n, n, n, 11);
+        BipartiteGraph g(inst.n1, inst.n2, inst.edges);
+        g.initialMatching(BipartiteGraph::InitStrategy::KarpSipser);
+        int expected = g.maxMatchingHopcroftKarp();
+        g.initialMatching(BipartiteGraph::InitStrategy::KarpSipser);
+        EXPECT_EQ(g.maxMatchingKuhn(), expected);
+        checkMatchingAndCover(g, inst, expected);
+    }
+}
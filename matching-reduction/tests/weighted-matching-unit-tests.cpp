@@ -0,0 +1,174 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include "weighted_matching.hpp"
+
+using Edges = std::vector<WeightedEdge>;
+
+namespace {
+
+constexpr long long None = std::numeric_limits<long long>::min();
+
+// best weight over all matchings by trying every choice for every left vertex, small graphs only.
+// perfect - every left vertex has to be matched, minimum cost instead of maximum weight
+long long bruteWeight(int n1, const Edges& edges, int u, std::vector<bool>& usedR, bool perfect) {
+    if (u > n1) {
+        return 0;
+    }
+    long long best = perfect ? None : bruteWeight(n1, edges, u + 1, usedR, perfect);
+    for (const WeightedEdge& e : edges) {
+        if (e.u == u && !usedR[e.v]) {
+            usedR[e.v] = true;
+            long long rest = bruteWeight(n1, edges, u + 1, usedR, perfect);
+            usedR[e.v] = false;
+            if (rest == None) {
+                continue;
+            }
+            long long w = perfect ? -e.w + rest : e.w + rest;
+            best = std::max(best, w);
+        }
+    }
+    return best;
+}
+
+// matching uses existing edges, every right vertex once, and has the reported weight
+void checkMatching(int n2, const Edges& edges, const WeightedMatching& res) {
+    std::vector<bool> usedR(n2 + 1);
+    long long weight = 0;
+    for (std::size_t u = 1; u < res.edgeL.size(); ++u) {
+        int e = res.edgeL[u];
+        if (e == 0) {
+            continue;
+        }
+        const WeightedEdge& ed = edges[e - 1];
+        EXPECT_EQ(ed.u, static_cast<int>(u));
+        EXPECT_FALSE(usedR[ed.v]);
+        usedR[ed.v] = true;
+        weight += ed.w;
+    }
+    EXPECT_EQ(weight, res.weight);
+}
+
+Edges randomEdges(std::mt19937& gen, int n1, int n2, int m, int maxW) {
+    Edges edges(m);
+    for (auto& e : edges) {
+        e.u = gen() % n1 + 1;
+        e.v = gen() % n2 + 1;
+        e.w = static_cast<long long>(gen() % (2 * maxW + 1)) - maxW / 2;
+    }
+    return edges;
+}
+
+} // namespace
+
+TEST(WeightedMatching, heavy_edge_beats_two_light_ones) {
+    Edges edges = {{1, 1, 3}, {1, 2, 10}, {2, 2, 4}};
+    for (const auto& res : {hungarianMaxWeight(2, 2, edges), auctionMaxWeight(2, 2, edges, 1)}) {
+        EXPECT_EQ(res.weight, 10);
+        EXPECT_EQ(res.size(), 1);
+        EXPECT_EQ(res.edgeL[1], 2);
+        checkMatching(2, edges, res);
+    }
+}
+
+TEST(WeightedMatching, bad_endpoint_throws) {
+    EXPECT_THROW(hungarianMaxWeight(2, 2, {{3, 1, 1}}), std::out_of_range);
+    EXPECT_THROW(auctionMaxWeight(2, 2, {{1, 0, 1}}), std::out_of_range);
+}
+
+TEST(WeightedMatching, empty_and_non_positive) {
+    Edges edges = {{1, 1, 0}, {2, 1, -5}};
+    for (const auto& res : {hungarianMaxWeight(2, 3, edges), auctionMaxWeight(2, 3, edges), hungarianMaxWeight(2, 3, {})}) {
+        EXPECT_EQ(res.weight, 0);
+        EXPECT_EQ(res.size(), 0);
+    }
+}
+
+TEST(WeightedMatching, max_weight_against_brute_force) {
+    std::mt19937 gen(46);
+    for (int iter = 0; iter < 400; ++iter) {
+        int n1 = gen() % 6 + 1;
+        int n2 = gen() % 6 + 1;
+        Edges edges = randomEdges(gen, n1, n2, gen() % 14, 20);
+
+        std::vector<bool> usedR(n2 + 1);
+        long long expected = bruteWeight(n1, edges, 1, usedR, false);
+
+        auto hungarian = hungarianMaxWeight(n1, n2, edges);
+        EXPECT_EQ(hungarian.weight, expected);
+        checkMatching(n2, edges, hungarian);
+        for (unsigned threads : {1u, 3u}) {
+            auto auction = auctionMaxWeight(n1, n2, edges, threads);
+            EXPECT_EQ(auction.weight, expected);
+            checkMatching(n2, edges, auction);
+        }
+    }
+}
+
+TEST(WeightedMatching, min_cost_perfect_against_brute_force) {
+    std::mt19937 gen(47);
+    for (int iter = 0; iter < 400; ++iter) {
+        int n1 = gen() % 5 + 1;
+        int n2 = n1 + gen() % 3;
+        Edges edges = randomEdges(gen, n1, n2, gen() % 16, 20);
+
+        std::vector<bool> usedR(n2 + 1);
+        long long expected = bruteWeight(n1, edges, 1, usedR, true);
+
+        auto res = hungarianMinCostPerfect(n1, n2, edges);
+        if (expected == None) {
+            EXPECT_FALSE(res.has_value());
+            continue;
+        }
+        ASSERT_TRUE(res.has_value());
+        EXPECT_EQ(res->weight, -expected);
+        EXPECT_EQ(res->size(), n1);
+        checkMatching(n2, edges, *res);
+    }
+    EXPECT_FALSE(hungarianMinCostPerfect(3, 2, {{1, 1, 1}}).has_value());
+}
+
+TEST(WeightedMatching, auction_matches_hungarian_on_larger_graphs) {
+    // edge numbers as weights, like the input of the main program
+    std::mt19937 gen(48);
+    const int n = 300;
+    Edges edges(6 * n);
+    for (std::size_t k = 0; k < edges.size(); ++k) {
+        edges[k] = {static_cast<int>(gen() % n + 1), static_cast<int>(gen() % n + 1), static_cast<long long>(k + 1)};
+    }
+    auto hungarian = hungarianMaxWeight(n, n, edges);
+    for (unsigned threads : {1u, 4u}) {
+        auto auction = auctionMaxWeight(n, n, edges, threads);
+        EXPECT_EQ(auction.weight, hungarian.weight);
+        checkMatching(n, edges, auction);
+    }
+
+    // few distinct weights, many ties between the bidders
+    for (auto& e : edges) {
+        e.w = gen() % 3 + 1;
+    }
+    hungarian = hungarianMaxWeight(n, n, edges);
+    auto auction = auctionMaxWeight(n, n, edges, 2);
+    EXPECT_EQ(auction.weight, hungarian.weight);
+    checkMatching(n, edges, auction);
+}
+
+TEST(WeightedMatching, auction_thread_team) {
+    // enough bidders for the rounds to be split among the team
+    std::mt19937 gen(49);
+    const int n = 20000;
+    Edges edges(4 * n);
+    for (std::size_t k = 0; k < edges.size(); ++k) {
+        edges[k] = {static_cast<int>(gen() % n + 1), static_cast<int>(gen() % n + 1), static_cast<long long>(gen() % 1000 + 1)};
+    }
+    auto single = auctionMaxWeight(n, n, edges, 1);
+    checkMatching(n, edges, single);
+    for (unsigned threads : {2u, 8u}) {
+        auto team = auctionMaxWeight(n, n, edges, threads);
+        EXPECT_EQ(team.weight, single.weight);
+        checkMatching(n, edges, team);
+    }
+}
@@ -0,0 +1,102 @@
+#include <benchmark/benchmark.h>
+#include <random>
+#include <vector>
+
+#include "rb_tree.hpp"
+
+// Range sum over a dynamic set: monoid-augmented tree vs scanning get_preorder()
+
+using sum_tree = rb::rb_tree<int, false, rb::sum_monoid<int, long long>>;
+
+namespace {
+
+template<typename Tree>
+void fill(Tree& t, int n, std::mt19937& gen) {
+    std::uniform_int_distribution<int> dist(0, n * 4);
+    for (int i = 0; i < n; ++i) {
+        t.insert(dist(gen));
+    }
+}
+
+std::vector<std::pair<int, int>> make_queries(int n, std::mt19937& gen) {
+    std::uniform_int_distribution<int> dist(0, n * 4);
+    std::vector<std::pair<int, int>> queries(1024);
+    for (auto& [lo, hi] : queries) {
+        lo = dist(gen);
+        hi = dist(gen);
+        if (hi < lo) {
+            std::swap(lo, hi);
+        }
+    }
+    return queries;
+}
+
+void BM_AggregateTree(benchmark::State& state) {
+    const int n = static_cast<int>(state.range(0));
+    std::mt19937 gen(42);
+    sum_tree t;
+    fill(t, n, gen);
+    auto queries = make_queries(n, gen);
+
+    size_t i = 0;
+    for (auto _ : state) {
+        auto [lo, hi] = queries[i++ % queries.size()];
+        benchmark::DoNotOptimize(t.aggregate(lo, hi));
+    }
+}
+
+void BM_AggregateScan(benchmark::State& state) {
+    const int n = static_cast<int>(state.range(0));
+    std::mt19937 gen(42);
+    rb::rb_tree<int> t;
+    fill(t, n, gen);
+    auto queries = make_queries(n, gen);
+
+    size_t i = 0;
+    for (auto _ : state) {
+        auto [lo, hi] = queries[i++ % queries.size()];
+        long long sum = 0;
+        for (auto [val, color] : t.get_preorder()) {
+            if (lo <= val && val <= hi) {
+                sum += val;
+            }
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+}
+
+// Cost of keeping aggregates up to date
+void BM_InsertRemoveAugmented(benchmark::State& state) {
+    const int n = static_cast<int>(state.range(0));
+    std::mt19937 gen(42);
+    sum_tree t;
+    fill(t, n, gen);
+    std::uniform_int_distribution<int> dist(0, n * 4);
+
+    for (auto _ : state) {
+        int val = dist(gen);
+        t.insert(val);
+        t.remove(val);
+    }
+}
+
+void BM_InsertRemovePlain(benchmark::State& state) {
+    const int n = static_cast<int>(state.range(0));
+    std::mt19937 gen(42);
+    rb::rb_tree<int> t;
+    fill(t, n, gen);
+    std::uniform_int_distribution<int> dist(0, n * 4);
+
+    for (auto _ : state) {
+        int val = dist(gen);
+        t.insert(val);
+        t.remove(val);
+    }
+}
+
+} // namespace
+
+BENCHMARK(BM_AggregateTree)->RangeMultiplier(8)->Range(1 << 10, 1 << 19);
+BENCHMARK(BM_AggregateScan)->RangeMultiplier(8)->Range(1 << 10, 1 << 19);
+BENCHMARK(BM_InsertRemoveAugmented)->RangeMultiplier(8)->Range(1 << 10, 1 << 19);
+BENCHMARK(BM_InsertRemovePlain)->RangeMultiplier(8)->Range(1 << 10, 1 << 19);
@@ -0,0 +1,34 @@
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+#include "bench_utils.hpp"
+
+// Replaces global operator new so benchmarks can report allocations per op.
+// Other forms (new[], nothrow) forward here by default.
+
+namespace {
+std::atomic<std::uint64_t> allocs{0};
+std::atomic<std::uint64_t> bytes{0};
+} // namespace
+
+std::uint64_t bench::allocations() { return allocs.load(std::memory_order_relaxed); }
+std::uint64_t bench::allocated_bytes() { return bytes.load(std::memory_order_relaxed); }
+
+void* operator new(std::size_t size) {
+    allocs.fetch_add(1, std::memory_order_relaxed);
+    bytes.fetch_add(size, std::memory_order_relaxed);
+    if (void* p = std::malloc(size != 0 ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    std::free(p);
+}
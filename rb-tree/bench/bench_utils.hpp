@@ -0,0 +1,113 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+
+// Helpers shared by the benchmarks: key streams, allocation counter
+// (operator new is replaced in "alloc-counter.cpp") and resident memory.
+
+namespace bench {
+
+// number of calls to operator new / bytes requested since program start
+std::uint64_t allocations();
+std::uint64_t allocated_bytes();
+
+// current resident set size in bytes, 0 if unknown
+inline std::size_t resident_memory() {
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line)) {
+        if (line.rfind("VmRSS:", 0) == 0) {
+            return std::stoull(line.substr(6)) * 1024;
+        }
+    }
+    return 0;
+}
+
+enum stream : int {
+    Sequential = 0,
+    Random = 1,
+    Zipf = 2,
+};
+
+inline const char* stream_name(int s) {
+    switch (s) {
+        case Sequential: return "sequential";
+        case Random:     return "random";
+        case Zipf:       return "zipf";
+    }
+    return "?";
+}
+
+// n distinct keys 0, 2, 4, ... (odd keys are left free for misses and merges)
+// in ascending or random order
+inline std::vector<int> distinct_keys(std::size_t n, int s, std::uint32_t seed = 42) {
+    std::vector<int> keys(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        keys[i] = static_cast<int>(2 * i);
+    }
+    if (s != Sequential) {
+        std::mt19937 gen(seed);
+        std::shuffle(keys.begin(), keys.end(), gen);
+    }
+    return keys;
+}
+
+// Zipf(theta) over ranks 0..n-1, rank r is drawn with probability ~ 1 / (r+1)^theta
+class zipf_distribution {
+    std::vector<double> cdf_;
+
+  public:
+    explicit zipf_distribution(std::size_t n, double theta = 0.99) : cdf_(n) {
+        double sum = 0;
+        for (std::size_t r = 0; r < n; ++r) {
+            sum += 1.0 / std::pow(static_cast<double>(r + 1), theta);
+            cdf_[r] = sum;
+        }
+        for (auto& c : cdf_) {
+            c /= sum;
+        }
+    }
+
+    template<typename Gen>
+    std::size_t operator()(Gen& gen) {
+        double u = std::uniform_real_distribution<double>(0, 1)(gen);
+        auto it = std::lower_bound(cdf_.begin(), cdf_.end(), u);
+        return std::min<std::size_t>(it - cdf_.begin(), cdf_.size() - 1);
+    }
+};
+
+// count lookups of keys from `keys` (as returned by distinct_keys):
+// sequential and random pick uniformly (half of them miss), zipf picks
+// present keys with skewed popularity, hot keys are spread over the key range
+inline std::vector<int> lookup_keys(const std::vector<int>& keys, std::size_t count, int s, std::uint32_t seed = 7) {
+    std::mt19937 gen(seed);
+    std::vector<int> res(count);
+    if (s == Zipf) {
+        zipf_distribution zipf(keys.size());
+        std::vector<int> shuffled = keys;
+        std::shuffle(shuffled.begin(), shuffled.end(), gen);
+        for (auto& k : res) {
+            k = shuffled[zipf(gen)];
+        }
+    } else if (s == Sequential) {
+        for (std::size_t i = 0; i < count; ++i) {
+            res[i] = static_cast<int>(i % (2 * keys.size()));
+        }
+    } else {
+        std::uniform_int_distribution<int> dist(0, static_cast<int>(2 * keys.size() - 1));
+        for (auto& k : res) {
+            k = dist(gen);
+        }
+    }
+    return res;
+}
+
+} // namespace bench
@@ -0,0 +1,69 @@
+#include <benchmark/benchmark.h>
+#include <memory>
+#include <mutex>
+#include <random>
+
+#include "concurrent_rb_tree.hpp"
+#include "rb_tree.hpp"
+
+// Read/write mix (50 lookups per update) on a shared ordered set:
+// concurrent_rb_tree vs rb_tree behind a global mutex
+
+namespace {
+
+constexpr int TreeSize = 1 << 16;
+constexpr int ReadsPerWrite = 50;
+
+struct locked_tree {
+    std::mutex mutex;
+    rb::rb_tree<int> tree;
+
+    void insert(int val) { std::lock_guard lock{mutex}; tree.insert(val); }
+    bool remove(int val) { std::lock_guard lock{mutex}; return tree.remove(val); }
+    bool contains(int val) { std::lock_guard lock{mutex}; return tree.contains(val); }
+};
+
+template<typename Tree>
+void read_write_mix(benchmark::State& state, std::unique_ptr<Tree>& shared) {
+    if (state.thread_index() == 0) {
+        shared = std::make_unique<Tree>();
+        for (int i = 0; i < TreeSize; ++i) {
+            shared->insert(i * 2);
+        }
+    }
+
+    std::mt19937 gen(state.thread_index());
+    std::uniform_int_distribution<int> dist(0, TreeSize * 2);
+    long ops = 0;
+    for (auto _ : state) {
+        int val = dist(gen);
+        if (ops++ % (ReadsPerWrite + 1) == 0) {
+            // odd keys are temporary, the set size stays the same
+            shared->insert(val | 1);
+            shared->remove(val | 1);
+        } else {
+            benchmark::DoNotOptimize(shared->contains(val));
+        }
+    }
+    state.SetItemsProcessed(ops);
+
+    if (state.thread_index() == 0) {
+        shared.reset();
+    }
+}
+
+std::unique_ptr<rb::concurrent_rb_tree<int>> concurrent;
+std::unique_ptr<locked_tree> locked;
+
+void BM_ReadWriteMixConcurrent(benchmark::State& state) {
+    read_write_mix(state, concurrent);
+}
+
+void BM_ReadWriteMixLocked(benchmark::State& state) {
+    read_write_mix(state, locked);
+}
+
+} // namespace
+
+BENCHMARK(BM_ReadWriteMixConcurrent)->ThreadRange(1, 32)->UseRealTime();
+BENCHMARK(BM_ReadWriteMixLocked)->ThreadRange(1, 32)->UseRealTime();
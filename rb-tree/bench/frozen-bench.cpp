@@ -0,0 +1,91 @@
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "rb_tree.hpp"
+
+// Lookups in rb_tree vs its frozen Eytzinger copy vs binary search in a sorted vector
+
+namespace {
+
+struct fixture {
+    rb::rb_tree<int> tree;
+    std::vector<int> sorted;
+    std::vector<int> queries;
+
+    explicit fixture(int n) {
+        std::mt19937 gen(42);
+        std::uniform_int_distribution<int> dist(0, n * 4);
+        for (int i = 0; i < n; ++i) {
+            int val = dist(gen);
+            tree.insert(val);
+            sorted.push_back(val);
+        }
+        std::sort(sorted.begin(), sorted.end());
+        queries.resize(1 << 16);
+        for (auto& q : queries) {
+            q = dist(gen);
+        }
+    }
+};
+
+void BM_TreeContains(benchmark::State& state) {
+    fixture f(static_cast<int>(state.range(0)));
+    size_t i = 0;
+    for (auto _ : state) {
+        int q = f.queries[i++ % f.queries.size()];
+        benchmark::DoNotOptimize(f.tree.contains(q));
+    }
+}
+
+void BM_TreeLowerBound(benchmark::State& state) {
+    fixture f(static_cast<int>(state.range(0)));
+    size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(f.tree.lower_bound(f.queries[i++ % f.queries.size()]));
+    }
+}
+
+void BM_FrozenContains(benchmark::State& state) {
+    fixture f(static_cast<int>(state.range(0)));
+    auto frozen = f.tree.freeze();
+    size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(frozen.contains(f.queries[i++ % f.queries.size()]));
+    }
+}
+
+void BM_FrozenLowerBound(benchmark::State& state) {
+    fixture f(static_cast<int>(state.range(0)));
+    auto frozen = f.tree.freeze();
+    size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(frozen.lower_bound(f.queries[i++ % f.queries.size()]));
+    }
+}
+
+void BM_SortedVectorLowerBound(benchmark::State& state) {
+    fixture f(static_cast<int>(state.range(0)));
+    size_t i = 0;
+    for (auto _ : state) {
+        int q = f.queries[i++ % f.queries.size()];
+        benchmark::DoNotOptimize(std::lower_bound(f.sorted.begin(), f.sorted.end(), q));
+    }
+}
+
+void BM_Freeze(benchmark::State& state) {
+    fixture f(static_cast<int>(state.range(0)));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(f.tree.freeze());
+    }
+}
+
+} // namespace
+
+BENCHMARK(BM_TreeContains)->RangeMultiplier(16)->Range(1 << 10, 1 << 22);
+BENCHMARK(BM_TreeLowerBound)->RangeMultiplier(16)->Range(1 << 10, 1 << 22);
+BENCHMARK(BM_FrozenContains)->RangeMultiplier(16)->Range(1 << 10, 1 << 22);
+BENCHMARK(BM_FrozenLowerBound)->RangeMultiplier(16)->Range(1 << 10, 1 << 22);
+BENCHMARK(BM_SortedVectorLowerBound)->RangeMultiplier(16)->Range(1 << 10, 1 << 22);
+BENCHMARK(BM_Freeze)->RangeMultiplier(16)->Range(1 << 10, 1 << 22);
@@ -0,0 +1,89 @@
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <optional>
+#include <random>
+#include <set>
+#include <vector>
+
+#include "rb_tree.hpp"
+
+// Ingest of sorted and near-sorted streams (timestamps with jitter):
+// plain insert vs finger/hinted insert vs std::set with end() hint.
+// Arguments are {n, jitter}, jitter 0 means strictly sorted.
+
+using tree = rb::rb_tree<int>;
+
+namespace {
+
+std::vector<int> near_sorted(std::size_t n, int jitter) {
+    std::mt19937 gen(42);
+    std::vector<int> keys(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        keys[i] = static_cast<int>(i) * 16 + (jitter > 0 ? static_cast<int>(gen() % jitter) : 0);
+    }
+    return keys;
+}
+
+void set_label(benchmark::State& state, std::size_t n) {
+    state.SetItemsProcessed(static_cast<std::int64_t>(n) * state.iterations());
+    state.SetLabel(state.range(1) == 0 ? "sorted" : "near-sorted");
+}
+
+void BM_TreeInsert(benchmark::State& state) {
+    auto keys = near_sorted(state.range(0), static_cast<int>(state.range(1)));
+    std::optional<tree> t;
+    for (auto _ : state) {
+        t.emplace();
+        for (int k : keys) {
+            t->insert(k);
+        }
+        state.PauseTiming();
+        t.reset();
+        state.ResumeTiming();
+    }
+    set_label(state, keys.size());
+}
+
+void BM_TreeFingerInsert(benchmark::State& state) {
+    auto keys = near_sorted(state.range(0), static_cast<int>(state.range(1)));
+    std::optional<tree> t;
+    for (auto _ : state) {
+        t.emplace();
+        for (int k : keys) {
+            t->insert(t->finger(), k);
+        }
+        state.PauseTiming();
+        t.reset();
+        state.ResumeTiming();
+    }
+    set_label(state, keys.size());
+}
+
+void BM_SetHintInsert(benchmark::State& state) {
+    auto keys = near_sorted(state.range(0), static_cast<int>(state.range(1)));
+    std::optional<std::set<int>> s;
+    for (auto _ : state) {
+        s.emplace();
+        for (int k : keys) {
+            s->insert(s->end(), k);
+        }
+        state.PauseTiming();
+        s.reset();
+        state.ResumeTiming();
+    }
+    set_label(state, keys.size());
+}
+
+// jitter of 64 shuffles each key with its ~4 neighbours
+void hint_args(benchmark::internal::Benchmark* b) {
+    for (int64_t n = 10'000; n <= 1'000'000; n *= 10) {
+        b->Args({n, 0});
+        b->Args({n, 64});
+    }
+}
+
+} // namespace
+
+BENCHMARK(BM_TreeInsert)->Apply(hint_args)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_TreeFingerInsert)->Apply(hint_args)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_SetHintInsert)->Apply(hint_args)->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,84 @@
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <sstream>
+#include <string>
+
+#include "bench_utils.hpp"
+#include "rb_tree.hpp"
+
+// Restoring a checkpoint: reinserting a get_preorder() dump vs load() from a
+// stream vs load_file() through mmap
+
+using tree = rb::rb_tree<int>;
+
+namespace {
+
+void fill(tree& t, std::size_t n) {
+    for (int k : bench::distinct_keys(n, bench::Random)) {
+        t.insert(k);
+    }
+}
+
+void BM_RestoreReinsert(benchmark::State& state) {
+    tree t;
+    fill(t, state.range(0));
+    auto dump = t.get_preorder();
+
+    std::optional<tree> restored;
+    for (auto _ : state) {
+        restored.emplace();
+        for (auto& [val, color] : dump) {
+            restored->insert(val);
+        }
+        state.PauseTiming();
+        restored.reset();
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.range(0) * state.iterations());
+}
+
+void BM_RestoreStream(benchmark::State& state) {
+    tree t;
+    fill(t, state.range(0));
+    std::stringstream buf;
+    t.save(buf);
+    const std::string data = buf.str();
+
+    std::optional<tree> restored;
+    for (auto _ : state) {
+        std::istringstream in(data);
+        restored.emplace();
+        restored->load(in);
+        state.PauseTiming();
+        restored.reset();
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.range(0) * state.iterations());
+}
+
+void BM_RestoreFile(benchmark::State& state) {
+    auto path = (std::filesystem::temp_directory_path() / "rb-tree-io-bench.bin").string();
+    // kept alive like in the other benchmarks, so the allocator state is the same
+    tree t;
+    fill(t, state.range(0));
+    t.save_file(path);
+
+    std::optional<tree> restored;
+    for (auto _ : state) {
+        restored.emplace();
+        restored->load_file(path);
+        state.PauseTiming();
+        restored.reset();
+        state.ResumeTiming();
+    }
+    std::filesystem::remove(path);
+    state.SetItemsProcessed(state.range(0) * state.iterations());
+}
+
+} // namespace
+
+BENCHMARK(BM_RestoreReinsert)->RangeMultiplier(10)->Range(10'000, 1'000'000)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_RestoreStream)->RangeMultiplier(10)->Range(10'000, 1'000'000)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_RestoreFile)->RangeMultiplier(10)->Range(10'000, 1'000'000)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,210 @@
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <optional>
+#include <set>
+#include <vector>
+
+#include "bench_utils.hpp"
+#include "rb_tree.hpp"
+
+// rb::rb_tree vs std::set on the core set operations.
+// Arguments are {n, key stream}. Every benchmark reports
+//   time_per_op    - time per single insert/remove/lookup/visited element
+//   allocs_per_op  - operator new calls per op (0 for lookups and traversal)
+//   bytes_per_elem - heap bytes requested per element while filling
+//   rss            - resident memory of the process with the container built
+
+using tree = rb::rb_tree<int>;
+using set  = std::set<int>;
+
+namespace {
+
+// same interface for both containers
+void insert(tree& t, int v) { t.insert(v); }
+void insert(set& s, int v) { s.insert(v); }
+
+bool remove(tree& t, int v) { return t.remove(v); }
+bool remove(set& s, int v) { return s.erase(v) != 0; }
+
+bool contains(tree& t, int v) { return t.contains(v); }
+bool contains(set& s, int v) { return s.contains(v); }
+
+void merge(tree& a, tree& b) { a.merge(std::move(b)); }
+void merge(set& a, set& b) { a.merge(b); }
+
+template<typename F>
+void for_each(const tree& t, F&& f) { t.for_each(f); }
+template<typename F>
+void for_each(const set& s, F&& f) {
+    for (int v : s) {
+        f(v);
+    }
+}
+
+// rb_tree is neither copyable nor movable, so containers are filled in place
+template<typename Set>
+void fill(Set& s, const std::vector<int>& keys) {
+    for (int k : keys) {
+        insert(s, k);
+    }
+}
+
+void report(benchmark::State& state, std::size_t ops_per_iter, std::uint64_t allocs) {
+    using benchmark::Counter;
+    const double ops = static_cast<double>(ops_per_iter) * static_cast<double>(state.iterations());
+    state.counters["time_per_op"] = Counter(ops, Counter::kIsRate | Counter::kInvert);
+    state.counters["allocs_per_op"] = static_cast<double>(allocs) / ops;
+    state.SetItemsProcessed(static_cast<std::int64_t>(ops));
+}
+
+template<typename Set>
+void report_memory(benchmark::State& state, const std::vector<int>& keys) {
+    auto bytes_before = bench::allocated_bytes();
+    Set s;
+    fill(s, keys);
+    state.counters["bytes_per_elem"] = static_cast<double>(bench::allocated_bytes() - bytes_before) / keys.size();
+    state.counters["rss"] = benchmark::Counter(static_cast<double>(bench::resident_memory()),
+                                               benchmark::Counter::kDefaults, benchmark::Counter::kIs1024);
+}
+
+template<typename Set>
+void BM_Insert(benchmark::State& state) {
+    auto keys = bench::distinct_keys(state.range(0), static_cast<int>(state.range(1)));
+    state.SetLabel(bench::stream_name(static_cast<int>(state.range(1))));
+
+    std::uint64_t allocs = 0;
+    std::optional<Set> s;
+    for (auto _ : state) {
+        s.emplace();
+        auto before = bench::allocations();
+        fill(*s, keys);
+        allocs += bench::allocations() - before;
+
+        state.PauseTiming();
+        s.reset(); // don't time destruction
+        state.ResumeTiming();
+    }
+    report(state, keys.size(), allocs);
+    report_memory<Set>(state, keys);
+}
+
+template<typename Set>
+void BM_Remove(benchmark::State& state) {
+    auto keys = bench::distinct_keys(state.range(0), static_cast<int>(state.range(1)));
+    state.SetLabel(bench::stream_name(static_cast<int>(state.range(1))));
+
+    std::uint64_t allocs = 0;
+    for (auto _ : state) {
+        state.PauseTiming();
+        Set s;
+        fill(s, keys);
+        state.ResumeTiming();
+
+        auto before = bench::allocations();
+        for (int k : keys) {
+            benchmark::DoNotOptimize(remove(s, k));
+        }
+        allocs += bench::allocations() - before;
+    }
+    report(state, keys.size(), allocs);
+}
+
+template<typename Set>
+void BM_Contains(benchmark::State& state) {
+    const int stream = static_cast<int>(state.range(1));
+    auto keys = bench::distinct_keys(state.range(0), bench::Random);
+    auto queries = bench::lookup_keys(keys, 1 << 16, stream);
+    state.SetLabel(bench::stream_name(stream));
+    Set s;
+    fill(s, keys);
+
+    std::uint64_t allocs = 0;
+    for (auto _ : state) {
+        auto before = bench::allocations();
+        for (int q : queries) {
+            benchmark::DoNotOptimize(contains(s, q));
+        }
+        allocs += bench::allocations() - before;
+    }
+    report(state, queries.size(), allocs);
+}
+
+// range(2) is how many times the second set is smaller than the first
+template<typename Set>
+void BM_Merge(benchmark::State& state) {
+    const std::size_t n = state.range(0);
+    const std::size_t m = std::max<std::size_t>(n / state.range(2), 1);
+    auto keys = bench::distinct_keys(n, static_cast<int>(state.range(1)));
+    auto other_keys = bench::distinct_keys(m, static_cast<int>(state.range(1)), 43);
+    for (int& k : other_keys) {
+        k = k * (static_cast<int>(n / m)) + 1; // odd, disjoint with keys and spread over their range
+    }
+    state.SetLabel(bench::stream_name(static_cast<int>(state.range(1))));
+
+    std::uint64_t allocs = 0;
+    std::optional<Set> a, b;
+    for (auto _ : state) {
+        state.PauseTiming();
+        a.emplace();
+        b.emplace();
+        fill(*a, keys);
+        fill(*b, other_keys);
+        state.ResumeTiming();
+
+        auto before = bench::allocations();
+        merge(*a, *b);
+        allocs += bench::allocations() - before;
+
+        state.PauseTiming();
+        a.reset();
+        b.reset();
+        state.ResumeTiming();
+    }
+    report(state, m, allocs); // per merged element
+}
+
+template<typename Set>
+void BM_Traverse(benchmark::State& state) {
+    auto keys = bench::distinct_keys(state.range(0), static_cast<int>(state.range(1)));
+    state.SetLabel(bench::stream_name(static_cast<int>(state.range(1))));
+    Set s;
+    fill(s, keys);
+
+    std::uint64_t allocs = 0;
+    for (auto _ : state) {
+        auto before = bench::allocations();
+        long long sum = 0;
+        for_each(s, [&](int v) { sum += v; });
+        benchmark::DoNotOptimize(sum);
+        allocs += bench::allocations() - before;
+    }
+    report(state, keys.size(), allocs);
+}
+
+// n in 1e3 .. 1e7
+void sizes(benchmark::internal::Benchmark* b, std::vector<int64_t> streams, std::vector<int64_t> extra = {1}) {
+    for (int64_t n = 1000; n <= 10'000'000; n *= 10) {
+        for (auto s : streams) {
+            for (auto e : extra) {
+                b->Args({n, s, e});
+            }
+        }
+    }
+}
+
+void update_args(benchmark::internal::Benchmark* b) { sizes(b, {bench::Sequential, bench::Random}); }
+void lookup_args(benchmark::internal::Benchmark* b) { sizes(b, {bench::Sequential, bench::Random, bench::Zipf}); }
+// equal sizes and the second set 100 times smaller
+void merge_args(benchmark::internal::Benchmark* b) { sizes(b, {bench::Sequential, bench::Random}, {1, 100}); }
+
+} // namespace
+
+#define SET_BENCHMARK(name, args)                                                        \
+    BENCHMARK_TEMPLATE(name, tree)->Apply(args)->Unit(benchmark::kMicrosecond);          \
+    BENCHMARK_TEMPLATE(name, set)->Apply(args)->Unit(benchmark::kMicrosecond)
+
+SET_BENCHMARK(BM_Insert,   update_args);
+SET_BENCHMARK(BM_Remove,   update_args);
+SET_BENCHMARK(BM_Contains, lookup_args);
+SET_BENCHMARK(BM_Merge,    merge_args);
+SET_BENCHMARK(BM_Traverse, update_args);
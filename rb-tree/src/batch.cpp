@@ -0,0 +1,172 @@
+#include "batch.hpp"
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <print>
+#include <string_view>
+#include <vector>
+
+#include "rb_tree.hpp"
+
+namespace {
+
+using clock_type = std::chrono::steady_clock;
+using tree = rb::rb_tree<int, true>; // order statistics for range counts
+
+enum op_type {
+    Insert,
+    Delete,
+    Find,
+    Range,
+    Switch,
+    Merge,
+    OpCount
+};
+
+constexpr std::array<const char*, OpCount> op_names = {"insert", "delete", "find", "range", "switch", "merge"};
+
+struct op {
+    op_type type;
+    int args[2] = {0, 0};
+};
+
+std::string_view skip_spaces(std::string_view s) {
+    while(!s.empty() && (s.front() == ' ' || s.front() == '\t')) {
+        s.remove_prefix(1);
+    }
+    return s;
+}
+
+bool parse_int(std::string_view& s, int& val) {
+    s = skip_spaces(s);
+    auto [end, ec] = std::from_chars(s.data(), s.data() + s.size(), val);
+    if(ec != std::errc{}) {
+        return false;
+    }
+    s.remove_prefix(end - s.data());
+    return true;
+}
+
+// returns false on malformed line, empty lines and comments give OpCount
+bool parse_line(std::string_view line, op& res, bool& stop) {
+    line = skip_spaces(line);
+    if(line.empty() || line.front() == '#') {
+        res.type = OpCount;
+        return true;
+    }
+
+    char cmd = line.front();
+    line.remove_prefix(1);
+    int n_args = 0;
+    switch(cmd) {
+        case 'i': res.type = Insert; n_args = 1; break;
+        case 'd': res.type = Delete; n_args = 1; break;
+        case 'f': res.type = Find;   n_args = 1; break;
+        case 'r': res.type = Range;  n_args = 2; break;
+        case 's': res.type = Switch; break;
+        case 'm': res.type = Merge;  break;
+        case 'q': res.type = OpCount; stop = true; return true;
+        default:
+            return false;
+    }
+    for(int i = 0; i < n_args; ++i) {
+        if(!parse_int(line, res.args[i])) {
+            return false;
+        }
+    }
+    line = skip_spaces(line);
+    return line.empty() || line.front() == '\r';
+}
+
+std::uint64_t percentile(std::vector<std::uint64_t>& sorted, double p) {
+    size_t idx = static_cast<size_t>(p * static_cast<double>(sorted.size() - 1) + 0.5);
+    return sorted[idx];
+}
+
+void report(std::array<std::vector<std::uint64_t>, OpCount>& latencies, clock_type::duration wall) {
+    std::uint64_t total_ops = 0;
+    std::uint64_t total_ns = 0;
+
+    std::println("{:<8} {:>10} {:>10} {:>10} {:>10} {:>10} {:>12}", "op", "count", "p50 ns", "p90 ns", "p99 ns", "max ns", "ops/s");
+    for(int type = 0; type < OpCount; ++type) {
+        auto& lat = latencies[type];
+        if(lat.empty()) {
+            continue;
+        }
+        std::sort(lat.begin(), lat.end());
+        std::uint64_t sum = 0;
+        for(auto ns : lat) {
+            sum += ns;
+        }
+        total_ops += lat.size();
+        total_ns += sum;
+
+        std::println("{:<8} {:>10} {:>10} {:>10} {:>10} {:>10} {:>12.0f}", op_names[type], lat.size(),
+                     percentile(lat, 0.5), percentile(lat, 0.9), percentile(lat, 0.99), lat.back(),
+                     sum == 0 ? 0.0 : static_cast<double>(lat.size()) * 1e9 / static_cast<double>(sum));
+    }
+
+    double wall_s = std::chrono::duration<double>(wall).count();
+    std::println("total: {} ops, {:.3f} ms in operations ({:.0f} ops/s), {:.3f} ms wall with parsing ({:.0f} ops/s)",
+                 total_ops, static_cast<double>(total_ns) / 1e6,
+                 total_ns == 0 ? 0.0 : static_cast<double>(total_ops) * 1e9 / static_cast<double>(total_ns),
+                 wall_s * 1e3, wall_s == 0 ? 0.0 : static_cast<double>(total_ops) / wall_s);
+}
+
+} // namespace
+
+int run_batch(std::istream& trace, const batch_options& opts) {
+    std::vector<tree> trees(2);
+    int id = 0;
+    std::array<std::vector<std::uint64_t>, OpCount> latencies;
+    size_t hits = 0; // successful deletes and lookups plus range counts
+
+    auto wall_start = clock_type::now();
+    std::string line;
+    size_t line_no = 0;
+    bool stop = false;
+    while(!stop && std::getline(trace, line)) {
+        line_no++;
+        op o{};
+        if(!parse_line(line, o, stop)) {
+            std::println(stderr, "line {}: malformed operation '{}'", line_no, line);
+            return 1;
+        }
+        if(o.type == OpCount) {
+            continue;
+        }
+
+        size_t found = 0;
+        auto start = clock_type::now();
+        switch(o.type) {
+            case Insert: trees[id].insert(o.args[0]); break;
+            case Delete: found = trees[id].remove(o.args[0]); break;
+            case Find:   found = trees[id].contains(o.args[0]); break;
+            case Range:  found = trees[id].count_range(o.args[0], o.args[1]); break;
+            case Switch: id = 1 - id; break;
+            case Merge:
+                trees[0].merge(std::move(trees[1]));
+                id = 0;
+                break;
+            default: break;
+        }
+        auto end = clock_type::now();
+        hits += found;
+        latencies[o.type].push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+    }
+    auto wall = clock_type::now() - wall_start;
+
+    std::println("tree sizes: {} {}, hits: {}", trees[0].size(), trees[1].size(), hits);
+    report(latencies, wall);
+
+    if(!opts.dot_path.empty()) {
+        std::ofstream dot{opts.dot_path};
+        trees[id].to_graphvis(dot, {.max_depth = 12});
+    }
+    return 0;
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <istream>
+#include <string>
+
+// Non-interactive mode of the CLI: replays an operation trace and reports
+// per-operation latency percentiles and throughput.
+//
+// Trace format, one operation per line ('#' starts a comment):
+//   i <val>       - insert
+//   d <val>       - delete
+//   f <val>       - lookup
+//   r <lo> <hi>   - count elements in [lo, hi]
+//   s             - switch to the other tree
+//   m             - merge 2nd tree into 1st (and switch to 1st)
+//   q             - stop
+
+struct batch_options {
+    std::string dot_path; // write final tree here if not empty
+};
+
+// returns 0 on success, 1 on malformed trace
+int run_batch(std::istream& trace, const batch_options& opts);
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstddef>
+#include <initializer_list>
+#include <utility>
+
+#include "persistent_rb_tree.hpp"
+
+namespace rb {
+
+// Thread-safe ordered set for read-mostly workloads.
+// Updates are serialized and build a new version with the path-copying
+// logic of persistent_rb_tree, then publish it with a single atomic store.
+// Lookups never lock: they pin an epoch, load the current version and walk
+// immutable nodes. A replaced version is released only after every reader
+// that could have loaded it has unpinned (see "epoch.hpp"). Publishing and
+// reclamation are persistent_rb_tree's, this is its set interface without
+// snapshots.
+template<typename T>
+class concurrent_rb_tree : NonCopyable {
+    using size_t = std::size_t;
+
+    persistent_rb_tree<T> tree_;
+
+  public:
+    concurrent_rb_tree() {}
+    concurrent_rb_tree(std::initializer_list<T> l) : tree_(l) {}
+
+    void insert(T val) { tree_.insert(std::move(val)); }
+    // returns false if element wasn't found
+    bool remove(const T& val) { return tree_.remove(val); }
+
+    // lock-free
+    bool contains(const T& val) const { return tree_.contains(val); }
+    size_t size() const { return tree_.size(); }
+};
+
+} // namespace rb
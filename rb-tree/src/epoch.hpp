@@ -0,0 +1,93 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+
+#include "rb_tree.hpp"
+
+namespace rb {
+
+// Epoch-based reclamation.
+// Readers pin() the domain while they hold pointers into shared data. A writer
+// that unlinked an object calls retire_epoch() and may free the object once
+// safe_epoch() is greater than the returned tag: every reader that could
+// have seen the object has unpinned by then.
+class epoch_domain : NonCopyable {
+  public:
+    using epoch_t = std::uint64_t;
+    static constexpr std::size_t MaxReaders = 128; // concurrently pinned readers
+
+  private:
+    static constexpr epoch_t Inactive = std::numeric_limits<epoch_t>::max();
+
+    struct alignas(64) slot {
+        std::atomic<bool> in_use{false};
+        std::atomic<epoch_t> epoch{Inactive};
+    };
+
+    std::atomic<epoch_t> global_epoch_{1};
+    slot slots_[MaxReaders];
+
+    // slot that this thread used last time, tried first
+    static std::size_t& slot_hint() {
+        thread_local std::size_t hint = 0;
+        return hint;
+    }
+
+    slot* acquire_slot() {
+        std::size_t &hint = slot_hint();
+        for(std::size_t i = 0; i < MaxReaders; ++i) {
+            std::size_t idx = (hint + i) % MaxReaders;
+            bool expected = false;
+            if(slots_[idx].in_use.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+                hint = idx;
+                return &slots_[idx];
+            }
+        }
+        throw std::runtime_error("epoch_domain: too many concurrent readers");
+    }
+
+  public:
+    class guard : NonCopyable {
+        slot *slot_;
+
+      public:
+        explicit guard(epoch_domain& d) : slot_(d.acquire_slot()) {
+            slot_->epoch.store(d.global_epoch_.load(std::memory_order_seq_cst), std::memory_order_seq_cst);
+            // loads of shared pointers after this are ordered after the epoch announcement
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+        }
+
+        ~guard() {
+            slot_->epoch.store(Inactive, std::memory_order_release);
+            slot_->in_use.store(false, std::memory_order_release);
+        }
+    };
+
+    // Readers: keep returned guard alive while using shared pointers
+    guard pin() { return guard{*this}; }
+
+    // Writers: call after unlinking (publishing a replacement), returns retire tag
+    epoch_t retire_epoch() {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        return global_epoch_.fetch_add(1, std::memory_order_seq_cst);
+    }
+
+    // Objects retired with tag < safe_epoch() are not referenced by any reader
+    epoch_t safe_epoch() const {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        epoch_t min = global_epoch_.load(std::memory_order_seq_cst);
+        for(const auto& s : slots_) {
+            epoch_t e = s.epoch.load(std::memory_order_seq_cst);
+            if(e < min) {
+                min = e;
+            }
+        }
+        return min;
+    }
+};
+
+} // namespace rb
@@ -3,8 +3,10 @@
 #include <cstdlib>
 #include <fstream>
 #include <iostream>
+#include <string_view>
 #include <vector>
 
+#include "batch.hpp"
 #include "rb_tree.hpp"
 
 void greeting() {
@@ -44,7 +46,42 @@ class graphvisor{
 
 };
 
-int main() {
+void usage() {
+    std::println("Usage:");
+    std::println("\trb-tree                                  - interactive mode");
+    std::println("\trb-tree --batch [trace | -] [--dot path] - replay trace (stdin by default), see batch.hpp");
+}
+
+int main(int argc, char* argv[]) {
+    if(argc > 1) {
+        std::string_view mode = argv[1];
+        if(mode != "--batch") {
+            usage();
+            return mode == "--help" ? 0 : 1;
+        }
+
+        std::string trace_path = "-";
+        batch_options opts;
+        for(int i = 2; i < argc; ++i) {
+            std::string_view arg = argv[i];
+            if(arg == "--dot" && i + 1 < argc) {
+                opts.dot_path = argv[++i];
+            } else {
+                trace_path = arg;
+            }
+        }
+
+        if(trace_path == "-") {
+            return run_batch(std::cin, opts);
+        }
+        std::ifstream trace{trace_path};
+        if(!trace) {
+            std::println(stderr, "Can't open {}", trace_path);
+            return 1;
+        }
+        return run_batch(trace, opts);
+    }
+
     greeting();
     graphvisor gv;
     std::string dot_buf;
@@ -0,0 +1,398 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+#include <cassert>
+
+#include "epoch.hpp"
+#include "rb_tree.hpp"
+
+namespace rb {
+
+// Persistent (path-copying) red-black tree.
+// Nodes are immutable and have no parent_ pointer, so versions share all
+// untouched subtrees. insert/remove copy only the O(log n) search path.
+// Nodes are reference counted, a version keeps its nodes alive.
+//
+// Writers (insert/remove) are serialized internally. Readers never lock:
+// the current version is published through an atomic pointer, snapshot(),
+// contains() and size() pin an epoch and load it, a replaced version is freed
+// once no reader can still be looking at it (see "epoch.hpp"). The version
+// returned by snapshot() is immutable and can be traversed without any
+// synchronization.
+template<typename T>
+class persistent_rb_tree : NonCopyable {
+    using size_t = std::size_t;
+
+    struct node;
+
+    // intrusive reference to a node
+    class node_ref {
+        node *n_ = nullptr;
+
+      public:
+        node_ref() {}
+        explicit node_ref(node* n) : n_(n) {} // adopts reference
+        node_ref(const node_ref& other) : n_(other.n_) { acquire(n_); }
+        node_ref(node_ref&& other) noexcept : n_(std::exchange(other.n_, nullptr)) {}
+        node_ref& operator=(node_ref other) noexcept { std::swap(n_, other.n_); return *this; }
+        ~node_ref() { release(n_); }
+
+        node* get() const { return n_; }
+        node* operator->() const { return n_; }
+        explicit operator bool() const { return n_ != nullptr; }
+    };
+
+    struct node {
+        enum {
+            Black = false,
+            Red = true
+        };
+
+        const T val_;
+        const bool color_;
+        const node_ref left_;
+        const node_ref right_;
+
+        mutable std::atomic<size_t> refs_{1};
+
+        static bool is_red  (const node_ref& n) { return n && n->color_ == Red; }
+        static bool is_black(const node_ref& n) { return !is_red(n); }
+    };
+
+    static void acquire(node* n) {
+        if(n != nullptr) {
+            n->refs_.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    static void release(node* n) {
+        if(n != nullptr && n->refs_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            delete n;
+        }
+    }
+
+    static node_ref make(bool color, node_ref left, const T& val, node_ref right) {
+        return node_ref{new node{val, color, std::move(left), std::move(right)}};
+    }
+
+    static node_ref with_color(const node_ref& n, bool color) {
+        if(n->color_ == color) {
+            return n;
+        }
+        return make(color, n->left_, n->val_, n->right_);
+    }
+
+  // balancing (Okasaki insert, Kahrs delete)
+    static node_ref balance(const node_ref&, const T&, const node_ref&);
+    static node_ref balance_left(const node_ref&, const T&, const node_ref&);
+    static node_ref balance_right(const node_ref&, const T&, const node_ref&);
+    static node_ref fuse(const node_ref&, const node_ref&);
+
+    static node_ref insert_impl(const node_ref&, const T&);
+    static node_ref remove_impl(const node_ref&, const T&);
+
+    static bool contains_impl(const node*, const T&);
+    static void get_preorder_impl(const node*, std::vector<std::pair<T, bool>>&);
+
+  public:
+    // Immutable version of the tree, cheap to copy
+    class version {
+        friend persistent_rb_tree;
+
+        node_ref root_;
+        size_t size_ = 0;
+
+        version(node_ref root, size_t size) : root_(std::move(root)), size_(size) {}
+
+      public:
+        version() {}
+
+        bool contains(const T& val) const { return contains_impl(root_.get(), val); }
+        size_t size() const { return size_; }
+        bool empty() const { return size_ == 0; }
+
+        std::vector<std::pair<T, bool>> get_preorder() const;
+        // calls f(val) for every element in ascending order
+        template<typename F>
+        void for_each(F&& f) const;
+    };
+
+    persistent_rb_tree() : current_(new version) {}
+    persistent_rb_tree(std::initializer_list<T> l) : persistent_rb_tree() {
+      for(auto& v : l) {
+        insert(v);
+      }
+    }
+
+    void insert(T val);
+    // returns false if element wasn't found
+    bool remove(const T& val);
+
+    ~persistent_rb_tree() { delete current_.load(std::memory_order_relaxed); }
+
+    // lock-free
+    bool contains(const T& val) const;
+    size_t size() const;
+
+    // O(1), lock-free
+    version snapshot() const;
+
+  private:
+    void publish(version);
+    void reclaim();
+
+    std::mutex writer_mutex_;              // serializes insert/remove
+    std::atomic<const version*> current_;  // replaced only by writers
+
+    mutable epoch_domain epochs_;
+    std::deque<std::pair<epoch_domain::epoch_t, std::unique_ptr<const version>>> retired_; // guarded by writer_mutex_
+};
+
+// Balancing
+//   fixes a red-red violation in any grandchild position, result is red;
+//   otherwise builds a black node
+template<typename T>
+persistent_rb_tree<T>::node_ref persistent_rb_tree<T>::balance(const node_ref& l, const T& val, const node_ref& r) {
+  if(node::is_red(l) && node::is_red(r)) {
+    return make(node::Red, with_color(l, node::Black), val, with_color(r, node::Black));
+  }
+  if(node::is_red(l)) {
+    if(node::is_red(l->left_)) {
+      return make(node::Red, with_color(l->left_, node::Black), l->val_, make(node::Black, l->right_, val, r));
+    }
+    if(node::is_red(l->right_)) {
+      const node_ref& lr = l->right_;
+      return make(node::Red, make(node::Black, l->left_, l->val_, lr->left_), lr->val_, make(node::Black, lr->right_, val, r));
+    }
+  }
+  if(node::is_red(r)) {
+    if(node::is_red(r->right_)) {
+      return make(node::Red, make(node::Black, l, val, r->left_), r->val_, with_color(r->right_, node::Black));
+    }
+    if(node::is_red(r->left_)) {
+      const node_ref& rl = r->left_;
+      return make(node::Red, make(node::Black, l, val, rl->left_), rl->val_, make(node::Black, rl->right_, r->val_, r->right_));
+    }
+  }
+  return make(node::Black, l, val, r);
+}
+
+// l lost one black level
+template<typename T>
+persistent_rb_tree<T>::node_ref persistent_rb_tree<T>::balance_left(const node_ref& l, const T& val, const node_ref& r) {
+  if(node::is_red(l)) {
+    return make(node::Red, with_color(l, node::Black), val, r);
+  }
+  if(node::is_black(r)) {
+    assert(r);
+    return balance(l, val, with_color(r, node::Red));
+  }
+  // r is red, its left child is black and not empty
+  const node_ref& rl = r->left_;
+  assert(node::is_black(rl) && rl);
+  return make(node::Red, make(node::Black, l, val, rl->left_), rl->val_,
+              balance(rl->right_, r->val_, with_color(r->right_, node::Red)));
+}
+
+// r lost one black level
+template<typename T>
+persistent_rb_tree<T>::node_ref persistent_rb_tree<T>::balance_right(const node_ref& l, const T& val, const node_ref& r) {
+  if(node::is_red(r)) {
+    return make(node::Red, l, val, with_color(r, node::Black));
+  }
+  if(node::is_black(l)) {
+    assert(l);
+    return balance(with_color(l, node::Red), val, r);
+  }
+  // l is red, its right child is black and not empty
+  const node_ref& lr = l->right_;
+  assert(node::is_black(lr) && lr);
+  return make(node::Red, balance(with_color(l->left_, node::Red), l->val_, lr->left_), lr->val_,
+              make(node::Black, lr->right_, val, r));
+}
+
+// Joins two subtrees of equal black height, all of l <= all of r
+template<typename T>
+persistent_rb_tree<T>::node_ref persistent_rb_tree<T>::fuse(const node_ref& l, const node_ref& r) {
+  if(!l) {
+    return r;
+  }
+  if(!r) {
+    return l;
+  }
+
+  if(node::is_red(l) && node::is_red(r)) {
+    node_ref mid = fuse(l->right_, r->left_);
+    if(node::is_red(mid)) {
+      return make(node::Red, make(node::Red, l->left_, l->val_, mid->left_), mid->val_,
+                             make(node::Red, mid->right_, r->val_, r->right_));
+    }
+    return make(node::Red, l->left_, l->val_, make(node::Red, mid, r->val_, r->right_));
+  }
+  if(node::is_black(l) && node::is_black(r)) {
+    node_ref mid = fuse(l->right_, r->left_);
+    if(node::is_red(mid)) {
+      return make(node::Red, make(node::Black, l->left_, l->val_, mid->left_), mid->val_,
+                             make(node::Black, mid->right_, r->val_, r->right_));
+    }
+    return balance_left(l->left_, l->val_, make(node::Black, mid, r->val_, r->right_));
+  }
+  if(node::is_red(r)) {
+    return make(node::Red, fuse(l, r->left_), r->val_, r->right_);
+  }
+  return make(node::Red, l->left_, l->val_, fuse(l->right_, r));
+}
+
+// Main logic
+template<typename T>
+persistent_rb_tree<T>::node_ref persistent_rb_tree<T>::insert_impl(const node_ref& n, const T& val) {
+  if(!n) {
+    return make(node::Red, {}, val, {});
+  }
+
+  if(val < n->val_) {
+    node_ref left = insert_impl(n->left_, val);
+    return n->color_ == node::Black ? balance(left, n->val_, n->right_)
+                                    : make(node::Red, std::move(left), n->val_, n->right_);
+  }
+  node_ref right = insert_impl(n->right_, val);
+  return n->color_ == node::Black ? balance(n->left_, n->val_, right)
+                                  : make(node::Red, n->left_, n->val_, std::move(right));
+}
+
+// val must be present in the subtree
+template<typename T>
+persistent_rb_tree<T>::node_ref persistent_rb_tree<T>::remove_impl(const node_ref& n, const T& val) {
+  assert(n);
+
+  if(val < n->val_) {
+    node_ref left = remove_impl(n->left_, val);
+    return node::is_black(n->left_) ? balance_left(left, n->val_, n->right_)
+                                    : make(node::Red, std::move(left), n->val_, n->right_);
+  }
+  if(n->val_ < val) {
+    node_ref right = remove_impl(n->right_, val);
+    return node::is_black(n->right_) ? balance_right(n->left_, n->val_, right)
+                                     : make(node::Red, n->left_, n->val_, std::move(right));
+  }
+  return fuse(n->left_, n->right_);
+}
+
+template<typename T>
+void persistent_rb_tree<T>::insert(T val) {
+  std::lock_guard writer{writer_mutex_};
+  const version& current = *current_.load(std::memory_order_relaxed);
+
+  node_ref root = insert_impl(current.root_, val);
+  publish(version{with_color(root, node::Black), current.size_ + 1});
+}
+
+template<typename T>
+bool persistent_rb_tree<T>::remove(const T& val) {
+  std::lock_guard writer{writer_mutex_};
+  const version& current = *current_.load(std::memory_order_relaxed);
+
+  if(!current.contains(val)) {
+    return false;
+  }
+
+  node_ref root = remove_impl(current.root_, val);
+  if(root) {
+    root = with_color(root, node::Black);
+  }
+  publish(version{std::move(root), current.size_ - 1});
+  return true;
+}
+
+// writer_mutex_ must be held
+template<typename T>
+void persistent_rb_tree<T>::publish(version v) {
+  std::unique_ptr<const version> old{current_.exchange(new version{std::move(v)}, std::memory_order_seq_cst)};
+
+  // readers may still be copying the old version
+  retired_.emplace_back(epochs_.retire_epoch(), std::move(old));
+  reclaim();
+}
+
+// writer_mutex_ must be held
+template<typename T>
+void persistent_rb_tree<T>::reclaim() {
+  auto safe = epochs_.safe_epoch();
+  while(!retired_.empty() && retired_.front().first < safe) {
+    retired_.pop_front();
+  }
+}
+
+template<typename T>
+persistent_rb_tree<T>::version persistent_rb_tree<T>::snapshot() const {
+  auto guard = epochs_.pin();
+  return *current_.load(std::memory_order_seq_cst); // the copy holds its own reference to the root
+}
+
+template<typename T>
+bool persistent_rb_tree<T>::contains(const T& val) const {
+  auto guard = epochs_.pin();
+  return current_.load(std::memory_order_seq_cst)->contains(val);
+}
+
+template<typename T>
+typename persistent_rb_tree<T>::size_t persistent_rb_tree<T>::size() const {
+  auto guard = epochs_.pin();
+  return current_.load(std::memory_order_seq_cst)->size();
+}
+
+template<typename T>
+bool persistent_rb_tree<T>::contains_impl(const node* n, const T& val) {
+  while(n != nullptr) {
+    if(val < n->val_) {
+      n = n->left_.get();
+    } else if(n->val_ < val) {
+      n = n->right_.get();
+    } else {
+      return true;
+    }
+  }
+  return false;
+}
+
+template<typename T>
+std::vector<std::pair<T, bool>> persistent_rb_tree<T>::version::get_preorder() const {
+  std::vector<std::pair<T, bool>> v;
+  get_preorder_impl(root_.get(), v);
+  return v;
+}
+
+template<typename T>
+void persistent_rb_tree<T>::get_preorder_impl(const node* n, std::vector<std::pair<T, bool>>& v) {
+  if (n == nullptr) {
+    return;
+  }
+  v.push_back({n->val_, n->color_});
+  get_preorder_impl(n->left_.get(), v);
+  get_preorder_impl(n->right_.get(), v);
+}
+
+template<typename T>
+template<typename F>
+void persistent_rb_tree<T>::version::for_each(F&& f) const {
+  std::vector<const node*> stack;
+  const node *n = root_.get();
+  while(n != nullptr || !stack.empty()) {
+    while(n != nullptr) {
+      stack.push_back(n);
+      n = n->left_.get();
+    }
+    n = stack.back();
+    stack.pop_back();
+    f(n->val_);
+    n = n->right_.get();
+  }
+}
+
+} // namespace rb
@@ -0,0 +1,135 @@
+#pragma once
+
+#include <functional>
+#include <initializer_list>
+#include <utility>
+
+#include "rb_tree.hpp"
+
+namespace rb {
+
+// Orders map entries by key only, entries can be looked up by a bare key
+template<typename K, typename V, typename Compare>
+struct map_key_compare {
+    using is_transparent = void;
+    using entry = std::pair<K, V>;
+
+    [[no_unique_address]] Compare comp;
+
+    bool operator()(const entry& a, const entry& b) const { return comp(a.first, b.first); }
+    bool operator()(const entry& a, const K& b) const { return comp(a.first, b); }
+    bool operator()(const K& a, const entry& b) const { return comp(a, b.first); }
+};
+
+// Ordered map with unique keys.
+// Entries (key, value) are stored right in rb_tree nodes, so balancing,
+// join/split/unite and traversal are the ones of rb_tree.
+template<typename K, typename V, typename Compare = std::less<K>, node_layout Layout = node_layout::pointers>
+class rb_map : NonCopyable {
+    using size_t = std::size_t;
+    using entry = std::pair<K, V>;
+    using tree = rb_tree<entry, false, void, Layout, map_key_compare<K, V, Compare>>;
+
+    tree tree_;
+
+  public:
+    rb_map() {}
+    rb_map(std::initializer_list<entry> l) {
+      for(auto& [key, value] : l) {
+        insert_or_assign(key, value);
+      }
+    }
+
+    size_t size() const { return tree_.size(); }
+    bool empty() const { return size() == 0; }
+
+    // Constructs value from args if key is absent, one descent.
+    // Returns the value for key and whether it was inserted.
+    template<typename... Args>
+    std::pair<V*, bool> try_emplace(const K& key, Args&&... args);
+    // inserts default-constructed value if key is absent
+    V& operator[](const K& key) { return *try_emplace(key).first; }
+    // returns true if key was inserted, false if its value was replaced
+    template<typename M>
+    bool insert_or_assign(const K& key, M&& value);
+
+    // nullptr if key is absent
+    V* find(const K& key);
+    const V* find(const K& key) const;
+    bool contains(const K& key) const { return tree_.contains(key); }
+    // returns false if key wasn't found
+    bool remove(const K& key) { return tree_.remove(key); }
+
+    // calls f(key, value) for every entry in ascending key order
+    template<typename F>
+    void for_each(F&& f);
+    template<typename F>
+    void for_each(F&& f) const;
+
+    // Moves all entries of other into this map. For keys present in both
+    // resolve(key, V&& mine, V&& theirs) gives the value to keep.
+    template<typename Resolve>
+    void merge(rb_map&& other, Resolve&& resolve);
+    // keeps values of this map on conflicts
+    void merge(rb_map&& other) {
+      merge(std::move(other), [](const K&, V&& mine, V&&) { return std::move(mine); });
+    }
+};
+
+template<typename K, typename V, typename Compare, node_layout Layout>
+template<typename... Args>
+std::pair<V*, bool> rb_map<K, V, Compare, Layout>::try_emplace(const K& key, Args&&... args) {
+  auto [n, inserted] = tree_.find_or_link(key, [&] {
+    return entry(std::piecewise_construct, std::forward_as_tuple(key), std::forward_as_tuple(std::forward<Args>(args)...));
+  });
+  return {&n->val_.second, inserted};
+}
+
+template<typename K, typename V, typename Compare, node_layout Layout>
+template<typename M>
+bool rb_map<K, V, Compare, Layout>::insert_or_assign(const K& key, M&& value) {
+  bool assigned = false;
+  auto [n, inserted] = tree_.find_or_link(key, [&] {
+    assigned = true;
+    return entry(key, std::forward<M>(value));
+  });
+  if(!assigned) {
+    n->val_.second = std::forward<M>(value);
+  }
+  return inserted;
+}
+
+template<typename K, typename V, typename Compare, node_layout Layout>
+V* rb_map<K, V, Compare, Layout>::find(const K& key) {
+  auto n = tree_.search(key);
+  return n != nullptr ? &n->val_.second : nullptr;
+}
+
+template<typename K, typename V, typename Compare, node_layout Layout>
+const V* rb_map<K, V, Compare, Layout>::find(const K& key) const {
+  auto n = tree_.search(key);
+  return n != nullptr ? &n->val_.second : nullptr;
+}
+
+template<typename K, typename V, typename Compare, node_layout Layout>
+template<typename F>
+void rb_map<K, V, Compare, Layout>::for_each(F&& f) {
+  tree_.for_each([&](entry& e) { f(std::as_const(e.first), e.second); });
+}
+
+template<typename K, typename V, typename Compare, node_layout Layout>
+template<typename F>
+void rb_map<K, V, Compare, Layout>::for_each(F&& f) const {
+  tree_.for_each([&](const entry& e) { f(e.first, e.second); });
+}
+
+template<typename K, typename V, typename Compare, node_layout Layout>
+template<typename Resolve>
+void rb_map<K, V, Compare, Layout>::merge(rb_map&& other, Resolve&& resolve) {
+  // kept node comes from this map, dropped one from other
+  tree_.merge_impl(std::move(other.tree_), [&](auto kept, auto dropped) {
+    kept->val_.second = resolve(std::as_const(kept->val_.first), std::move(kept->val_.second), std::move(dropped->val_.second));
+  });
+}
+
+} // namespace rb
@@ -1,12 +1,24 @@
 #pragma once
 
 #include <cstddef>
+#include <cstdint>
+#include <format>
+#include <functional>
 #include <initializer_list>
+#include <iosfwd>
+#include <ostream>
+#include <sstream>
 #include <stdexcept>
 #include <utility>
 #include <vector>
 #include <string>
 #include <cassert>
+#include <type_traits>
+
+#include "rb_tree_frozen.hpp"
+#include "rb_tree_layout.hpp"
+#include "rb_tree_monoid.hpp"
+#include "rb_tree_serializer.hpp"
 
 class NonCopyable {
   public:
@@ -19,87 +31,335 @@ typedef int error_t;
 
 namespace rb {
 
-template<typename T>
+// Placeholder for node fields that are switched off by template parameters,
+// takes no space thanks to [[no_unique_address]] (as long as types differ)
+template<int Id>
+struct empty_field {};
+
+// Monoid = void means no aggregate
+template<typename Monoid>
+struct monoid_traits {
+    static constexpr bool enabled = true;
+    using value_type = typename Monoid::value_type;
+};
+
+template<>
+struct monoid_traits<void> {
+    static constexpr bool enabled = false;
+    using value_type = empty_field<1>;
+};
+
+// Size bounds for rb_tree::to_graphvis(std::ostream&), subtrees past them
+// are drawn as a single summary node
+struct graphvis_limits {
+    std::size_t max_depth = SIZE_MAX; // root has depth 0
+    std::size_t max_nodes = SIZE_MAX;
+};
+
+template<typename K, typename V, typename Compare, node_layout Layout>
+class rb_map; // see "rb_map.hpp", uses insertion and merge internals
+
+// OrderStatistics - keep subtree sizes in nodes, enables select/rank/count_range
+// Monoid          - keep subtree aggregates in nodes, enables aggregate (see "rb_tree_monoid.hpp")
+// Layout          - how nodes are linked (see "rb_tree_layout.hpp")
+// Compare         - strict weak ordering, lookups accept any key type if Compare::is_transparent exists
+// Counted         - equivalent elements share one node with a counter, insert/remove are O(log distinct)
+template<typename T, bool OrderStatistics = false, typename Monoid = void, node_layout Layout = node_layout::pointers,
+         typename Compare = std::less<T>, bool Counted = false>
 class rb_tree : NonCopyable {
+    template<typename, typename, typename, node_layout>
+    friend class rb_map;
+
   // fields
     using size_t = std::size_t;
+    static constexpr bool has_monoid = monoid_traits<Monoid>::enabled;
+    static constexpr bool augmented = OrderStatistics || has_monoid;
+    static constexpr bool transparent = requires { typename Compare::is_transparent; };
+
     size_t size_ = 0;
 
     struct node; // see "rb_tree_node.hpp" for definition
-    node *root_ = nullptr;
+    using node_ptr = typename node_links<node, Layout>::pointer;
+    node_ptr root_ = nullptr;
+
+    // Last inserted node and its in-order successor, nullptr after removals
+    node_ptr finger_ = nullptr;
+    node_ptr finger_next_ = nullptr;
+
+    [[no_unique_address]] Compare comp_;
 
   // methods
-    static node* rotate(rb_tree<T>*, node*, int);
+    template<typename A, typename B>
+    bool less(const A& a, const B& b) const { return comp_(a, b); }
+    template<typename A, typename B>
+    bool equivalent(const A& a, const B& b) const { return !comp_(a, b) && !comp_(b, a); }
+
+    static node_ptr rotate(rb_tree*, node_ptr, int);
+
+    void fix_insert(node_ptr);
+    node_ptr link(node_ptr);
+    node_ptr link_below(node_ptr, node_ptr, node_ptr);
+    void absorb(node_ptr, node_ptr);
+    void attach(node_ptr, node_ptr, int);
+    template<typename K, typename Make>
+    std::pair<node_ptr, bool> find_or_link(const K& key, Make&& make);
+    void unlink(node_ptr);
+    void transplant(node_ptr, node_ptr);
+
+    template<typename K>
+    node_ptr search(const K& key) const;
+    // first node not less than key
+    template<typename K>
+    node_ptr lower_bound_node(const K& key) const;
+    // in-order successor, nullptr for the last node
+    static node_ptr next(node_ptr);
+    template<typename K>
+    bool remove_impl(const K& key);
+    void delete_fixup(node_ptr, node_ptr);
+
+    // splits the first tree around the separator, a node of it equivalent to the
+    // separator is left out and returned in equal
+    std::pair<node_ptr, node_ptr> split(node_ptr, node_ptr, node_ptr& equal) const;
+    // the first tree's node is kept over an equivalent node of the second one:
+    // on_equal(kept, dropped) is called before dropped is freed
+    template<typename OnEqual>
+    node_ptr unite(node_ptr, node_ptr, OnEqual&) const;
+    template<typename OnEqual>
+    void merge_impl(rb_tree&&, OnEqual);
+    static node_ptr join(node_ptr, node_ptr, node_ptr);
+    static node_ptr join_right(node_ptr, node_ptr, node_ptr);
+    static node_ptr join_left(node_ptr, node_ptr, node_ptr);
+    static size_t black_height(node_ptr);
+
+    static size_t subtree_size(node_ptr);
+    // number of elements kept in n
+    static size_t multiplicity(node_ptr n);
+    static void update(node_ptr);
+    static void update_to_root(node_ptr);
+    size_t count_less(const T& val, bool inclusive) const;
+
+    void free(node_ptr);
+
+    void get_preorder_impl(node_ptr, std::vector<std::pair<T, bool>>&);
+    static void get_inorder_impl(node_ptr, std::vector<T>&);
+    static size_t count_nodes(node_ptr);
+
+    template<typename Next>
+    node_ptr build_sorted(size_t count, size_t depth, size_t red_depth, Next& next);
+    template<typename Next>
+    void assign_sorted(size_t count, Next&& next);
 
-    void fix_insert(node*);
-    node* bst_insert(T&& val);
+  public:
+    using aggregate_type = typename monoid_traits<Monoid>::value_type;
 
-    node* search(const T& val);
-    node* bst_prepare_to_delete(const T& val);
-    void delete_fixup(node*);
+  private:
+    static aggregate_type subtree_aggregate(node_ptr);
+    // Monoid::lift of all elements kept in n
+    static aggregate_type lifted(node_ptr);
 
-    static std::pair<node*, node*> split(node*, node*);
-    static node* unite(node*, node*);
-    static node* join(node*, node*, node*);
-    static node* join_right(node*, node*, node*);
-    static node* join_left(node*, node*, node*);
-    static size_t black_height(node*);
+  public:
+    // Owns a node extracted from a tree, can be inserted back into any tree of
+    // the same type without reallocation (like std::set::node_type)
+    class node_handle {
+        friend rb_tree;
+        node_ptr n_ = nullptr;
+
+        explicit node_handle(node_ptr n) : n_(n) {}
+
+      public:
+        node_handle() {}
+        node_handle(node_handle&& other) noexcept : n_(std::exchange(other.n_, nullptr)) {}
+        node_handle& operator=(node_handle other) noexcept { std::swap(n_, other.n_); return *this; }
+        ~node_handle() {
+          if(n_ != nullptr) {
+            node::destroy(n_);
+          }
+        }
 
-    void free(node*);
+        bool empty() const { return n_ == nullptr; }
+        explicit operator bool() const { return !empty(); }
+        // may be modified, the node is placed by its new value on insert
+        T& value() const { return n_->val_; }
+    };
 
-    void get_preorder_impl(node*, std::vector<std::pair<T, bool>>&);
-    void graphvis_traverse(node*, std::string&);
+    // Element of the tree for hinted insertion, valid until the element is removed
+    class position {
+        friend rb_tree;
+        node_ptr n_ = nullptr;
 
-  public:
+        explicit position(node_ptr n) : n_(n) {}
+
+      public:
+        position() {}
+
+        bool empty() const { return n_ == nullptr; }
+        const T& operator*() const { return n_->val_; }
+        const T* operator->() const { return &n_->val_; }
+        bool operator==(const position&) const = default;
+    };
 
     rb_tree() {}
-    rb_tree(std::initializer_list<T> l) {
+    explicit rb_tree(const Compare& comp) : comp_(comp) {}
+    rb_tree(std::initializer_list<T> l, const Compare& comp = Compare{}) : comp_(comp) {
       for(auto& v : l) {
-        insert(std::move(v));
+        insert(v);
       }
     }
 
     ~rb_tree() { free(root_); }
 
     void insert(T val);
-    // returns false if element wasn't found
-    bool remove(T val);
+    // constructs the value from args right in the new node
+    template<typename... Args>
+    void emplace(Args&&... args) { link(node::create(std::in_place, std::forward<Args>(args)...)); }
+    // empty handle is ignored
+    void insert(node_handle&& nh);
+    // Inserts val starting the search from hint (finger search): climbs from
+    // hint only as far as needed, O(log d) for d elements between hint and val.
+    // Amortized O(1) if val goes right after finger() (sorted appends).
+    // Empty hint means finger().
+    position insert(position hint, T val);
+    // position of the last inserted element, empty after removals
+    position finger() const { return position{finger_}; }
+
+    // returns false if element wasn't found, removes one element
+    bool remove(const T& val) { return remove_impl(val); }
+    template<typename K> requires transparent
+    bool remove(const K& key) { return remove_impl(key); }
+    // removes all elements equivalent to key, returns their number
+    template<typename K> requires (transparent || std::is_same_v<K, T>)
+    size_t erase(const K& key) {
+      if constexpr (Counted) {
+        node_ptr n = extract_node(key);
+        if(n == nullptr) {
+          return 0;
+        }
+        size_t cnt = multiplicity(n);
+        node::destroy(n);
+        return cnt;
+      }
+      size_t cnt = 0;
+      while(remove_impl(key)) {
+        cnt++;
+      }
+      return cnt;
+    }
+    // number of elements equivalent to key, O(log n) with Counted and O(log n + k) otherwise
+    template<typename K> requires (transparent || std::is_same_v<K, T>)
+    size_t count(const K& key) const {
+      if constexpr (Counted) {
+        node_ptr n = search(key);
+        return n != nullptr ? multiplicity(n) : 0;
+      }
+      size_t cnt = 0;
+      for(node_ptr n = lower_bound_node(key); n != nullptr && !less(key, n->val_); n = next(n)) {
+        cnt++;
+      }
+      return cnt;
+    }
 
+    // Unlinks one element equivalent to key, empty handle if there is none.
+    // With Counted the handle takes all equivalent elements.
+    node_handle extract(const T& val) { return node_handle{extract_node(val)}; }
+    template<typename K> requires transparent
+    node_handle extract(const K& key) { return node_handle{extract_node(key)}; }
+
+    // Elements of other that are equivalent to elements of this tree are dropped
+    // (this tree's element is kept), with Counted their counts are added up instead
     void merge(rb_tree&&);
-    bool contains(T&);
 
-    std::vector<std::pair<T, bool>> get_preorder();
-    size_t size() const { return size_; }
+    bool contains(const T& val) const { return search(val) != nullptr; }
+    template<typename K> requires transparent
+    bool contains(const K& key) const { return search(key) != nullptr; }
 
-    void to_graphvis(std::string&);
+    // element equivalent to key, nullptr if there is none
+    const T* find(const T& val) const { return value_or_null(search(val)); }
+    template<typename K> requires transparent
+    const T* find(const K& key) const { return value_or_null(search(key)); }
 
+    // first element not less than val, nullptr if there is none
+    const T* lower_bound(const T& val) const;
+
+    const Compare& key_comp() const { return comp_; }
+
+    // Immutable copy for read-heavy workloads, O(n) (see "rb_tree_frozen.hpp")
+    frozen_set<T, Compare> freeze() const;
+
+    // Binary snapshot of the elements in ascending order, see "rb_tree_io.hpp".
+    // load replaces contents and rebuilds a balanced tree in O(n),
+    // throws std::runtime_error on malformed input (the tree is left unchanged)
+    void save(std::ostream&) const;
+    void load(std::istream&);
+    void save_file(const std::string& path) const;
+    // maps the file instead of reading it if T is trivially copyable
+    void load_file(const std::string& path);
+
+    // (value, color) of every node, with Counted equivalent elements share one
+    std::vector<std::pair<T, bool>> get_preorder();
+    // calls f(val) for every element in ascending order, O(n) without extra memory
+    template<typename F>
+    void for_each(F&& f) const;
+    size_t size() const { return size_; }
+    // bytes taken by one element
+    static constexpr size_t node_size() { return sizeof(node); }
+
+    // Order statistics (only with OrderStatistics = true), all O(log n)
+    // k-th smallest element (0-based), throws std::out_of_range if k >= size()
+    const T& select(size_t k) const;
+    // number of elements less than val
+    size_t rank(const T& val) const;
+    // number of elements in [lo, hi]
+    size_t count_range(const T& lo, const T& hi) const;
+
+    // Aggregates (only with Monoid), O(log n)
+    // Monoid::combine of all elements in [lo, hi] in key order
+    aggregate_type aggregate(const T& lo, const T& hi) const;
+    // aggregate of the whole tree, O(1)
+    aggregate_type aggregate() const;
+
+    // DOT description of the tree (see "rb_tree_graphvis.hpp")
+    void to_graphvis(std::string&) const;
+    // writes as it goes, suitable for large trees
+    void to_graphvis(std::ostream&, const graphvis_limits& limits = {}) const;
+
+  private:
+    template<typename K>
+    node_ptr extract_node(const K& key);
+    static const T* value_or_null(node_ptr n) { return n != nullptr ? &n->val_ : nullptr; }
 };
 
+#define RB_TREE_TEMPLATE template<typename T, bool OrderStatistics, typename Monoid, node_layout Layout, typename Compare, bool Counted>
+#define RB_TREE rb_tree<T, OrderStatistics, Monoid, Layout, Compare, Counted>
+
 #include "rb_tree_node.hpp"
 #include "rb_tree_graphvis.hpp"
+#include "rb_tree_io.hpp"
 
 // Main logic
-template<typename T>
-rb_tree<T>::node* rb_tree<T>::rotate(rb_tree<T>* tree, node* n, const int dir) {
+RB_TREE_TEMPLATE
+RB_TREE::node_ptr RB_TREE::rotate(RB_TREE* tree, node_ptr n, const int dir) {
   assert(n);
 
-  node *par = n->parent_;
-  node *suc = n->child(node::reverse_dir(dir));
+  node_ptr par = n->parent();
+  node_ptr suc = n->child(node::reverse_dir(dir));
   assert(suc);
-  node *suc_child = suc->child(dir);
+  node_ptr suc_child = suc->child(dir);
 
-  n->child(node::reverse_dir(dir)) = suc_child;
+  n->set_child(node::reverse_dir(dir), suc_child);
   if (suc_child) {
-    suc_child->parent_ = n;
+    suc_child->set_parent(n);
   }
-  n->parent_ = suc;
+  n->set_parent(suc);
 
-  suc->child(dir) = n;
-  suc->parent_ = par;
+  suc->set_child(dir, n);
+  suc->set_parent(par);
+
+  update(n);
+  update(suc);
   
   if (par) {
     auto par_dir = par->left() == n ? node::Left : node::Right;
-    par->child(par_dir) = suc;
+    par->set_child(par_dir, suc);
   } else {
     if(tree != nullptr) {
       assert(n == tree->root_);
@@ -111,225 +371,483 @@ rb_tree<T>::node* rb_tree<T>::rotate(rb_tree<T>* tree, node* n, const int dir) {
   return suc;
 }
 
-template<typename T>
-void rb_tree<T>::fix_insert(node* n) {  
+RB_TREE_TEMPLATE
+void RB_TREE::fix_insert(node_ptr n) {  
   while(n != root_ && 
-        node::is_red(n) && node::is_red(n->parent_)) {
-      auto *parent = n->parent_;
-      auto *grandparent = parent->parent_;
+        node::is_red(n) && node::is_red(n->parent())) {
+      auto parent = n->parent();
+      auto grandparent = parent->parent();
       
       const int parent_dir = parent == grandparent->left() ? node::Left : node::Right;
-      node *uncle = grandparent->child(node::reverse_dir(parent_dir));
+      node_ptr uncle = grandparent->child(node::reverse_dir(parent_dir));
       if(uncle != nullptr && node::is_red(uncle)) {
-        grandparent->color_ = node::Red;
-        parent->color_      = node::Black;
-        uncle->color_       = node::Black;
+        grandparent->set_color(node::Red);
+        parent->set_color(node::Black);
+        uncle->set_color(node::Black);
         n = grandparent;
       } else {
         const int dir = n == parent->left() ? node::Left : node::Right;
         if (dir == node::reverse_dir(parent_dir)) {
           rotate(this, parent, parent_dir);
           n = parent;
-          parent = n->parent_;
+          parent = n->parent();
         }
         n = parent;
         rotate(this, grandparent, node::reverse_dir(parent_dir));
-        std::swap(parent->color_, grandparent->color_);
+        bool parent_color = parent->color();
+        parent->set_color(grandparent->color());
+        grandparent->set_color(parent_color);
         return;
         }
       }
 
-  root_->color_ = node::Black;  
+  root_->set_color(node::Black);  
 }
 
-template<typename T>
-rb_tree<T>::node* rb_tree<T>::bst_insert(T&& val) {
-  auto *n = new rb_tree<T>::node{};
-  n->val_ = std::move(val);
-
-  if(root_ == nullptr) {
-    root_ = n;
-    return root_;
-    }
+// Inserts a detached node (no parent and children) and rebalances.
+// Returns the node that keeps n's value, with Counted n may be absorbed.
+RB_TREE_TEMPLATE
+RB_TREE::node_ptr RB_TREE::link(node_ptr n) {
+  return link_below(n, root_, nullptr);
+}
 
-  node *parent = nullptr;
-  node *current = root_;
-  while(true) {
+// Inserts n into subtree of start, which must cover n's position.
+// next is the successor of the whole subtree (nullptr if there is none).
+RB_TREE_TEMPLATE
+RB_TREE::node_ptr RB_TREE::link_below(node_ptr n, node_ptr start, node_ptr next) {
+  node_ptr parent = nullptr; // start is nullptr only in empty tree
+  node_ptr current = start;
+  int dir = node::Left;
+  while(current != nullptr) {
     parent = current;
-    auto dir = val < current->val_ ? node::Left : node::Right;
+    dir = less(n->val_, current->val_) ? node::Left : node::Right;
+    if(dir == node::Left) {
+      next = current;
+    } else if constexpr (Counted) {
+      if(!less(current->val_, n->val_)) {
+        absorb(current, n);
+        return current;
+      }
+    }
     current = current->child(dir);
-    
-    if(current == nullptr) {
-      n->parent_ = parent;
-      parent->child(dir) = n;
-      return n;       
+    }
+
+  attach(n, parent, dir);
+  finger_ = n;
+  finger_next_ = next;
+  return n;
+  }
+
+// Adds elements of detached n to the equivalent node kept and destroys n
+RB_TREE_TEMPLATE
+void RB_TREE::absorb(node_ptr kept, node_ptr n) {
+  static_assert(Counted);
+  kept->dups_ += multiplicity(n);
+  size_ += multiplicity(n);
+  update_to_root(kept);
+  node::destroy(n);
+}
+
+RB_TREE_TEMPLATE
+RB_TREE::position RB_TREE::insert(position hint, T val) {
+  node_ptr n = node::create(std::in_place, std::move(val));
+
+  node_ptr h = hint.empty() ? finger_ : hint.n_;
+  if(h == nullptr) {
+    return position{link(n)};
+  }
+  if constexpr (Counted) {
+    if(equivalent(n->val_, h->val_)) {
+      absorb(h, n);
+      return position{h};
+    }
+  }
+
+  // Fast path: n goes right after the finger
+  if(h == finger_ && !less(n->val_, h->val_) &&
+     (finger_next_ == nullptr || less(n->val_, finger_next_->val_))) {
+    node_ptr next = finger_next_;
+    if(h->right() == nullptr) {
+      attach(n, h, node::Right);
+    } else {
+      // next is the leftmost node of h's right subtree
+      attach(n, next, node::Left);
+    }
+    finger_ = n;
+    finger_next_ = next;
+    return position{n};
+  }
+
+  // Climb until the subtree of h covers n's position
+  node_ptr next = nullptr;
+  if(!less(n->val_, h->val_)) {
+    while(true) {
+      // nearest ancestor having h in its left subtree bounds the subtree from above
+      node_ptr child = h;
+      node_ptr bound = h->parent();
+      while(bound != nullptr && bound->right() == child) {
+        child = bound;
+        bound = bound->parent();
+      }
+      if(bound == nullptr || less(n->val_, bound->val_)) {
+        next = bound;
+        break;
+      }
+      h = bound;
+    }
+  } else {
+    while(true) {
+      // nearest ancestor having h in its right subtree bounds the subtree from below
+      node_ptr child = h;
+      node_ptr bound = h->parent();
+      while(bound != nullptr && bound->left() == child) {
+        child = bound;
+        bound = bound->parent();
       }
+      if(bound == nullptr || !less(n->val_, bound->val_)) {
+        if constexpr (Counted) {
+          // the only equivalent node outside the subtree of h
+          if(bound != nullptr && !less(bound->val_, n->val_)) {
+            absorb(bound, n);
+            return position{bound};
+          }
+        }
+        // n < h, so the descent turns left at least once and finds next itself
+        break;
+      }
+      h = bound;
     }
   }
 
-template<typename T>
-void rb_tree<T>::insert(T val) {
-  auto *n = bst_insert(std::move(val));
-  n->color_ = node::Red;
+  return position{link_below(n, h, next)};
+}
+
+// Hangs detached n as the dir child of parent (which must be free) and rebalances
+RB_TREE_TEMPLATE
+void RB_TREE::attach(node_ptr n, node_ptr parent, int dir) {
+  n->set_color(node::Red);
+  update(n);
+  size_ += multiplicity(n);
+
+  if(parent == nullptr) {
+    assert(root_ == nullptr);
+    root_ = n;
+    root_->set_color(node::Black);
+    return;
+  }
+
+  n->set_parent(parent);
+  parent->set_child(dir, n);
+  update_to_root(parent);
   fix_insert(n);
-  size_++;
+}
+
+// Single descent: returns node equivalent to key, or links make() in its place
+RB_TREE_TEMPLATE
+template<typename K, typename Make>
+std::pair<typename RB_TREE::node_ptr, bool> RB_TREE::find_or_link(const K& key, Make&& make) {
+  node_ptr parent = nullptr;
+  node_ptr current = root_;
+  node_ptr next = nullptr;
+  int dir = node::Left;
+  while(current != nullptr) {
+    if(less(key, current->val_)) {
+      dir = node::Left;
+      next = current;
+    } else if(less(current->val_, key)) {
+      dir = node::Right;
+    } else {
+      return {current, false};
+    }
+    parent = current;
+    current = current->child(dir);
+  }
+
+  node_ptr n = node::create(std::in_place, make());
+  attach(n, parent, dir);
+  finger_ = n;
+  finger_next_ = next;
+  return {n, true};
+}
+
+RB_TREE_TEMPLATE
+void RB_TREE::insert(T val) {
+  link(node::create(std::in_place, std::move(val)));
+}
+
+RB_TREE_TEMPLATE
+void RB_TREE::insert(node_handle&& nh) {
+  if(nh.empty()) {
+    return;
+  }
+  link(std::exchange(nh.n_, nullptr));
 }
 
 
-template<typename T>
-std::vector<std::pair<T, bool>> rb_tree<T>::get_preorder() {
+RB_TREE_TEMPLATE
+std::vector<std::pair<T, bool>> RB_TREE::get_preorder() {
   std::vector<std::pair<T, bool>> v;
   get_preorder_impl(root_, v);
   return v;
 }
 
-template<typename T>
-void rb_tree<T>::get_preorder_impl(node* n, std::vector<std::pair<T, bool>>& v) {
+RB_TREE_TEMPLATE
+void RB_TREE::get_preorder_impl(node_ptr n, std::vector<std::pair<T, bool>>& v) {
   if (n == nullptr) {
     return;
   }
-  v.push_back({n->val_, n->color_});
+  v.push_back({n->val_, n->color()});
   get_preorder_impl(n->left(), v);
   get_preorder_impl(n->right(), v);
 }
 
 
-// Searches for the *deepest* node
-template<typename T>
-rb_tree<T>::node* rb_tree<T>::search(const T& val) {
-  node *current = root_;
-  node *result = nullptr;
+RB_TREE_TEMPLATE
+void RB_TREE::get_inorder_impl(node_ptr n, std::vector<T>& v) {
+  if (n == nullptr) {
+    return;
+  }
+  get_inorder_impl(n->left(), v);
+  v.insert(v.end(), multiplicity(n), n->val_);
+  get_inorder_impl(n->right(), v);
+}
+
+RB_TREE_TEMPLATE
+template<typename F>
+void RB_TREE::for_each(F&& f) const {
+  node_ptr n = root_;
+  if(n == nullptr) {
+    return;
+  }
+  while(n->left() != nullptr) {
+    n = n->left();
+  }
+
+  while(n != nullptr) {
+    for(size_t i = 0; i < multiplicity(n); i++) {
+      f(n->val_);
+    }
+    n = next(n);
+  }
+}
+
+RB_TREE_TEMPLATE
+RB_TREE::node_ptr RB_TREE::next(node_ptr n) {
+  if(n->right() != nullptr) {
+    n = n->right();
+    while(n->left() != nullptr) {
+      n = n->left();
+    }
+    return n;
+  }
+  // climb until we come from a left subtree
+  node_ptr child = n;
+  n = n->parent();
+  while(n != nullptr && n->right() == child) {
+    child = n;
+    n = n->parent();
+  }
+  return n;
+}
+
+RB_TREE_TEMPLATE
+frozen_set<T, Compare> RB_TREE::freeze() const {
+  std::vector<T> sorted;
+  sorted.reserve(size_);
+  get_inorder_impl(root_, sorted);
+  return frozen_set<T, Compare>{sorted, comp_};
+}
+
+RB_TREE_TEMPLATE
+const T* RB_TREE::lower_bound(const T& val) const {
+  return value_or_null(lower_bound_node(val));
+}
+
+RB_TREE_TEMPLATE
+template<typename K>
+RB_TREE::node_ptr RB_TREE::lower_bound_node(const K& key) const {
+  node_ptr current = root_;
+  node_ptr result = nullptr;
 
   while (current != nullptr) {
-    if (current->val_ == val) {
+    if (less(current->val_, key)) {
+      current = current->right();
+    } else {
       result = current;
+      current = current->left();
     }
+  }
+  return result;
+}
 
-    if (current->val_ > val) {
+// Searches for the *deepest* node equivalent to key,
+// with Counted there is only one and the search stops there
+RB_TREE_TEMPLATE
+template<typename K>
+RB_TREE::node_ptr RB_TREE::search(const K& key) const {
+  node_ptr current = root_;
+  node_ptr result = nullptr;
+
+  while (current != nullptr) {
+    if (less(key, current->val_)) {
       current = current->left();
     } else {
+      if (!less(current->val_, key)) {
+        result = current;
+        if constexpr (Counted) {
+          break;
+        }
+      }
       current = current->right();
     }
   }
   return result;
 }
 
-template<typename T>
-rb_tree<T>::node* rb_tree<T>::bst_prepare_to_delete(const T& val) {
-  node *n = search(val);
-  if (n == nullptr) {
-    return nullptr;
+// Replaces subtree rooted at n with subtree rooted at m (m may be nullptr)
+RB_TREE_TEMPLATE
+void RB_TREE::transplant(node_ptr n, node_ptr m) {
+  node_ptr parent = n->parent();
+  if (parent == nullptr) {
+    root_ = m;
+  } else {
+    int dir = n == parent->left() ? node::Left : node::Right;
+    parent->set_child(dir, m);
+  }
+  if (m != nullptr) {
+    m->set_parent(parent);
   }
+}
 
-  int n_children = 0;
-  n_children += (n->left() != nullptr);
-  n_children += (n->right() != nullptr);  
+// Detaches n from the tree and rebalances, n itself is not destroyed.
+// Nodes are relinked rather than values swapped, so other nodes keep their values.
+RB_TREE_TEMPLATE
+void RB_TREE::unlink(node_ptr n) {
+  node_ptr child;          // takes the place of the removed node
+  node_ptr child_parent;
+  bool removed_color;
+
+  if (n->left() == nullptr || n->right() == nullptr) {
+    child = n->left() != nullptr ? n->left() : n->right();
+    child_parent = n->parent();
+    removed_color = n->color();
+    transplant(n, child);
+  } else {
+    // Successor - leftmost element in right subtree, it takes n's place and color
+    node_ptr successor = n->right();
+    while (successor->left() != nullptr) {
+      successor = successor->left();
+    }
+    removed_color = successor->color();
+    child = successor->right();
 
-  switch(n_children) {
-    case 0:
-      return n;
-    case 1: {
-      int dir = n->left() != nullptr ? node::Left : node::Right;
-      node *child = n->child(dir);
-      std::swap(n->val_, child->val_);
-      return child;
-    } 
-    case 2: {
-      // Successor - leftmost element in right subtree
-      node *successor = n->right();
-      while (successor != nullptr && successor->left() != nullptr) {
-        successor = successor->left();
-      }
-      std::swap(n->val_, successor->val_);
-      return successor;
+    if (successor->parent() == n) {
+      child_parent = successor;
+    } else {
+      child_parent = successor->parent();
+      transplant(successor, child);
+      successor->set_child(node::Right, n->right());
+      successor->right()->set_parent(successor);
     }
-    default:
-      assert(0 && "Panic");
-      throw std::runtime_error("Unexpected number of children in rb_tree");
+
+    transplant(n, successor);
+    successor->set_child(node::Left, n->left());
+    successor->left()->set_parent(successor);
+    successor->set_color(n->color());
   }
+  // successor (if moved) is on the path from child_parent to the root
+  update_to_root(child_parent);
+
+  if (removed_color == node::Black) {
+    delete_fixup(child, child_parent);
+  }
+
+  n->set_parent(nullptr);
+  n->set_child(node::Left, nullptr);
+  n->set_child(node::Right, nullptr);
+  size_ -= multiplicity(n);
+
+  finger_ = nullptr;
+  finger_next_ = nullptr;
 }
 
-template<typename T>
-void rb_tree<T>::delete_fixup(node* n) {
+// n may be nullptr (removed black leaf), so its parent is passed explicitly
+RB_TREE_TEMPLATE
+void RB_TREE::delete_fixup(node_ptr n, node_ptr parent) {
   while(n != root_ && node::is_black(n)) {
-    node *parent = n->parent_;
+    // sibling of n can't be nullptr: its subtree has larger black height
     int dir = n == parent->left() ? node::Left : node::Right;
-    node *sibling = parent->child(node::reverse_dir(dir));
+    node_ptr sibling = parent->child(node::reverse_dir(dir));
+    assert(sibling);
 
-    if(node::is_black(sibling)) {
-      parent->color_ = node::Red;
+    if(node::is_red(sibling)) {
+      sibling->set_color(node::Black);
+      parent->set_color(node::Red);
       rotate(this, parent, dir);
       sibling = parent->child(node::reverse_dir(dir));
     }
 
     // if sibling->children_ are Black
-    if(sibling != nullptr && 
-       node::is_black(sibling->left()) &&
+    if(node::is_black(sibling->left()) &&
        node::is_black(sibling->right())) {
-      sibling->color_ = node::Red;
+      sibling->set_color(node::Red);
       n = parent;
+      parent = n->parent();
       continue;
       }
 
-    if(sibling != nullptr && 
-       node::is_black(sibling->child(node::reverse_dir(dir)))) {
-      sibling->child(dir)->color_ = node::Black;
-      sibling->color_ = node::Red;
+    if(node::is_black(sibling->child(node::reverse_dir(dir)))) {
+      sibling->child(dir)->set_color(node::Black);
+      sibling->set_color(node::Red);
       rotate(this, sibling, node::reverse_dir(dir));
       sibling = parent->child(node::reverse_dir(dir));
       }
     
-    if(sibling != nullptr) { 
-      sibling->color_ = parent->color_;
-      node *nephew = sibling->child(node::reverse_dir(dir));
-      if(nephew != nullptr) {
-        nephew->color_ = node::Black;
-      }
-    }
-    parent->color_ = node::Black;
+    sibling->set_color(parent->color());
+    sibling->child(node::reverse_dir(dir))->set_color(node::Black);
+    parent->set_color(node::Black);
     rotate(this, parent, dir);
     n = root_;
   }
 
-  n->color_ = node::Black;
+  if(n != nullptr) {
+    n->set_color(node::Black);
+  }
+}
+
+RB_TREE_TEMPLATE
+template<typename K>
+RB_TREE::node_ptr RB_TREE::extract_node(const K& key) {
+  node_ptr n = search(key);
+  if (n != nullptr) {
+    unlink(n);
+  }
+  return n;
 }
 
-template<typename T>
-bool rb_tree<T>::remove(T val) {
-  node* n = bst_prepare_to_delete(val);
+RB_TREE_TEMPLATE
+template<typename K>
+bool RB_TREE::remove_impl(const K& key) {
+  node_ptr n = search(key);
   if (n == nullptr) {
     return false;
   }
-  
-  node *parent = n->parent_;
-  node *successor = n->left() != nullptr ? n->left() : n->right();
-
-  if (parent == nullptr) {
-    root_ = successor;
-  } else {
-    int dir = n == parent->left() ? node::Left : node::Right;
-    parent->child(dir) = successor;
-  }
-   
-
-  auto n_color = n->color_;
-  delete(n);
-  n = nullptr;
-
-  if(successor != nullptr) {
-    successor->parent_ = parent;
-
-    if (n_color == node::Black) {
-      delete_fixup(successor);
+  if constexpr (Counted) {
+    if (n->dups_ != 0) {
+      n->dups_--;
+      size_--;
+      update_to_root(n);
+      return true;
     }
   }
-
-  size_--;
+  unlink(n);
+  node::destroy(n);
   return true;
 }
 
-template<typename T>
-rb_tree<T>::node* rb_tree<T>::unite(node* t1, node* t2) {
+RB_TREE_TEMPLATE
+template<typename OnEqual>
+RB_TREE::node_ptr RB_TREE::unite(node_ptr t1, node_ptr t2, OnEqual& on_equal) const {
   if(t1 == nullptr) {
     return t2;
   }
@@ -337,133 +855,149 @@ rb_tree<T>::node* rb_tree<T>::unite(node* t1, node* t2) {
     return t1;
   }
 
-  auto [left, right] = split(t1, t2);
-  node* new_left  = unite(left,  t2->left());
-  node* new_right = unite(right, t2->right());
-  return join(new_left, t2, new_right);
+  node_ptr equal = nullptr;
+  auto [left, right] = split(t1, t2, equal);
+  node_ptr t2_left = t2->left();
+  node_ptr t2_right = t2->right();
+  node_ptr separator = t2;
+  if(equal != nullptr) {
+    on_equal(equal, t2);
+    node::destroy(t2);
+    separator = equal;
+  }
+  node_ptr new_left  = unite(left,  t2_left, on_equal);
+  node_ptr new_right = unite(right, t2_right, on_equal);
+  return join(new_left, separator, new_right);
 }
 
-template<typename T>
-std::pair<typename rb_tree<T>::node*, typename rb_tree<T>::node*> rb_tree<T>::split(node* n, node *separator) {
+RB_TREE_TEMPLATE
+std::pair<typename RB_TREE::node_ptr, typename RB_TREE::node_ptr> RB_TREE::split(node_ptr n, node_ptr separator,
+                                                                                 node_ptr& equal) const {
   if(n == nullptr) {
     return {nullptr, nullptr};
   }
-  if(n->val_ == separator->val_) {
+  if(equivalent(n->val_, separator->val_)) {
+    equal = n;
     return {n->left(), n->right()};
   }
-  if(separator->val_ < n->val_) {
-    auto [left, right] = split(n->left(), separator);
+  if(less(separator->val_, n->val_)) {
+    auto [left, right] = split(n->left(), separator, equal);
     return {left, join(right, n, n->right())};
   }
-  auto [left, right] = split(n->right(), separator);
+  auto [left, right] = split(n->right(), separator, equal);
   return {join(n->left(), n, left), right};
 }
 
-template<typename T>
-rb_tree<T>::node* rb_tree<T>::join(node *l, node *separator, node *r) {
+RB_TREE_TEMPLATE
+RB_TREE::node_ptr RB_TREE::join(node_ptr l, node_ptr separator, node_ptr r) {
     if(black_height(l) > black_height(r)) {
-      node *n = join_right(l, separator, r);
+      node_ptr n = join_right(l, separator, r);
       if(node::is_red(n) && node::is_red(n->right())) {
-         n->color_ = node::Black;
+         n->set_color(node::Black);
          }
       return n;
     }
 
     if(black_height(l) < black_height(r)) {
-      node *n = join_left(l, separator, r);
+      node_ptr n = join_left(l, separator, r);
       if(node::is_red(n) && node::is_red(n->left())) {
-         n->color_ = node::Black;
+         n->set_color(node::Black);
          }
       return n;
     }
 
-    separator->left() = l;
-    separator->right() = r;
+    separator->set_child(node::Left, l);
+    separator->set_child(node::Right, r);
     if(l != nullptr) {
-      l->parent_ = separator;
+      l->set_parent(separator);
     }
     if(r != nullptr) {
-      r->parent_ = separator;
+      r->set_parent(separator);
     }
     
     if(node::is_black(l) && node::is_black(r)) {
-      separator->color_ = node::Red;
+      separator->set_color(node::Red);
     } else {
-      separator->color_ = node::Black;
+      separator->set_color(node::Black);
     }
+    update(separator);
 
-    separator->parent_ = nullptr;
+    separator->set_parent(nullptr);
     return separator;
 }
 
-template<typename T>
-rb_tree<T>::node* rb_tree<T>::join_right(node *l, node *separator, node *r) {
+RB_TREE_TEMPLATE
+RB_TREE::node_ptr RB_TREE::join_right(node_ptr l, node_ptr separator, node_ptr r) {
   assert(separator);
 
   if(node::is_black(l) && black_height(l) == black_height(r)) {
-    separator->color_ = node::Red;
-    separator->left() = l;
-    separator->right() = r;
+    separator->set_color(node::Red);
+    separator->set_child(node::Left, l);
+    separator->set_child(node::Right, r);
     if(l != nullptr) {
-      l->parent_ = separator;
+      l->set_parent(separator);
     }
     if(r != nullptr) {
-      r->parent_ = separator;
+      r->set_parent(separator);
     }
+    update(separator);
 
     return separator;
   }
 
-  node *right_join = join_right(l->right(), separator, r);;
-  right_join->parent_ = l;
+  node_ptr right_join = join_right(l->right(), separator, r);;
+  right_join->set_parent(l);
 
-  l->right() = right_join;
-  l->parent_ = nullptr;
+  l->set_child(node::Right, right_join);
+  l->set_parent(nullptr);
+  update(l);
 
   if(node::is_black(l) && 
      node::is_red(l->right()) && node::is_red(l->right()->right())) {
-    l->right()->right()->color_ = node::Black;
+    l->right()->right()->set_color(node::Black);
     return rotate(nullptr, l, node::Left);
     } 
 
   return l;
 }
 
-template<typename T>
-rb_tree<T>::node* rb_tree<T>::join_left(node *l, node *separator, node *r) {
+RB_TREE_TEMPLATE
+RB_TREE::node_ptr RB_TREE::join_left(node_ptr l, node_ptr separator, node_ptr r) {
   
   if(node::is_black(r) && black_height(l) == black_height(r)) {
-    separator->color_ = node::Red;
-    separator->left() = l;
-    separator->right() = r;
+    separator->set_color(node::Red);
+    separator->set_child(node::Left, l);
+    separator->set_child(node::Right, r);
     if(l != nullptr) {
-      l->parent_ = separator;
+      l->set_parent(separator);
     }
     if(r != nullptr) {
-      r->parent_ = separator;
+      r->set_parent(separator);
     }
+    update(separator);
 
     return separator;
   }
 
 
-  node *left_join = join_left(l, separator, r->left());;
-  left_join->parent_ = r;
+  node_ptr left_join = join_left(l, separator, r->left());;
+  left_join->set_parent(r);
 
-  r->left() = left_join;
-  r->parent_ = nullptr;
+  r->set_child(node::Left, left_join);
+  r->set_parent(nullptr);
+  update(r);
 
   if(node::is_black(r) && 
     node::is_red(r->left()) && node::is_red(r->left()->left())) {
-    r->left()->left()->color_ = node::Black;
+    r->left()->left()->set_color(node::Black);
     return rotate(nullptr, r, node::Right);
     } 
 
   return r;
 }
 
-template<typename T>
-size_t rb_tree<T>::black_height(node* n) {
+RB_TREE_TEMPLATE
+size_t RB_TREE::black_height(node_ptr n) {
   size_t cnt = 0;
   while(n != nullptr) {
     if(node::is_black(n)) {
@@ -474,30 +1008,218 @@ size_t rb_tree<T>::black_height(node* n) {
 return cnt;
 }
 
-template<typename T>
-void rb_tree<T>::merge(rb_tree<T> &&other) {
+RB_TREE_TEMPLATE
+void RB_TREE::merge(rb_tree &&other) {
+  merge_impl(std::move(other), [](node_ptr, node_ptr) {});
+}
+
+RB_TREE_TEMPLATE
+template<typename OnEqual>
+void RB_TREE::merge_impl(rb_tree &&other, OnEqual on_equal) {
   if(&other == this) {
     return;
   }
-  root_ = unite(root_, other.root_);
+
+  // kept is updated by join after split returns
+  size_t dropped = 0;
+  auto count_dropped = [&](node_ptr kept, node_ptr n) {
+    on_equal(kept, n);
+    if constexpr (Counted) {
+      kept->dups_ += multiplicity(n);
+    } else {
+      dropped++;
+    }
+  };
+  root_ = unite(root_, other.root_, count_dropped);
   if(root_ != nullptr) {
-    root_->color_ = node::Black;
+    root_->set_parent(nullptr);
+    root_->set_color(node::Black);
   }
-
-  size_ += other.size_; // TODO this may be not valid because we allocating new nodes
+  size_ += other.size_ - dropped;
+  finger_ = nullptr;
+  finger_next_ = nullptr;
 
   other.root_ = nullptr;
   other.size_ = 0;
+  other.finger_ = nullptr;
+  other.finger_next_ = nullptr;
+}
+
+// Order statistics
+RB_TREE_TEMPLATE
+const T& RB_TREE::select(size_t k) const {
+  static_assert(OrderStatistics, "select() requires rb_tree with OrderStatistics");
+  if(k >= size_) {
+    throw std::out_of_range("rb_tree::select: index out of range");
+  }
+
+  node_ptr current = root_;
+  while(true) {
+    size_t left_size = subtree_size(current->left());
+    if(k < left_size) {
+      current = current->left();
+    } else if(k - left_size < multiplicity(current)) {
+      return current->val_;
+    } else {
+      k -= left_size + multiplicity(current);
+      current = current->right();
+    }
+  }
+}
+
+RB_TREE_TEMPLATE
+RB_TREE::size_t RB_TREE::rank(const T& val) const {
+  static_assert(OrderStatistics, "rank() requires rb_tree with OrderStatistics");
+  return count_less(val, false);
+}
+
+RB_TREE_TEMPLATE
+RB_TREE::size_t RB_TREE::count_range(const T& lo, const T& hi) const {
+  static_assert(OrderStatistics, "count_range() requires rb_tree with OrderStatistics");
+  if(less(hi, lo)) {
+    return 0;
+  }
+  return count_less(hi, true) - count_less(lo, false);
+}
+
+// Number of elements < val (or <= val if inclusive)
+RB_TREE_TEMPLATE
+RB_TREE::size_t RB_TREE::count_less(const T& val, bool inclusive) const {
+  size_t cnt = 0;
+  node_ptr current = root_;
+  while(current != nullptr) {
+    bool go_right = inclusive ? !less(val, current->val_) : less(current->val_, val);
+    if(go_right) {
+      cnt += subtree_size(current->left()) + multiplicity(current);
+      current = current->right();
+    } else {
+      current = current->left();
+    }
+  }
+  return cnt;
+}
+
+// Aggregates
+RB_TREE_TEMPLATE
+RB_TREE::aggregate_type RB_TREE::aggregate(const T& lo, const T& hi) const {
+  static_assert(has_monoid, "aggregate() requires rb_tree with Monoid");
+
+  // Find the topmost node inside [lo, hi], paths to lo and hi diverge there
+  node_ptr top = root_;
+  while(top != nullptr) {
+    if(less(top->val_, lo)) {
+      top = top->right();
+    } else if(less(hi, top->val_)) {
+      top = top->left();
+    } else {
+      break;
+    }
+  }
+  if(top == nullptr) {
+    return Monoid::identity();
+  }
+
+  // Path to lo: every node >= lo is taken together with its right subtree
+  aggregate_type left_part = Monoid::identity();
+  for(node_ptr n = top->left(); n != nullptr; ) {
+    if(less(n->val_, lo)) {
+      n = n->right();
+    } else {
+      left_part = Monoid::combine(Monoid::combine(lifted(n), subtree_aggregate(n->right())), left_part);
+      n = n->left();
+    }
+  }
+
+  // Path to hi: every node <= hi is taken together with its left subtree
+  aggregate_type right_part = Monoid::identity();
+  for(node_ptr n = top->right(); n != nullptr; ) {
+    if(less(hi, n->val_)) {
+      n = n->left();
+    } else {
+      right_part = Monoid::combine(right_part, Monoid::combine(subtree_aggregate(n->left()), lifted(n)));
+      n = n->right();
+    }
+  }
+
+  return Monoid::combine(Monoid::combine(left_part, lifted(top)), right_part);
 }
 
-template<typename T>
-bool rb_tree<T>::contains(T& val) {
-  return search(val) != nullptr;
+RB_TREE_TEMPLATE
+RB_TREE::aggregate_type RB_TREE::aggregate() const {
+  static_assert(has_monoid, "aggregate() requires rb_tree with Monoid");
+  return subtree_aggregate(root_);
 }
+
 // Other internals
+RB_TREE_TEMPLATE
+RB_TREE::size_t RB_TREE::subtree_size(node_ptr n) {
+  if constexpr (OrderStatistics) {
+    return n == nullptr ? 0 : n->subtree_size_;
+  } else {
+    assert(0 && "subtree sizes are kept only with OrderStatistics");
+    return 0;
+  }
+}
+
+RB_TREE_TEMPLATE
+RB_TREE::size_t RB_TREE::multiplicity(node_ptr n) {
+  if constexpr (Counted) {
+    return n->dups_ + 1;
+  } else {
+    return 1;
+  }
+}
+
+// Repeated lifts are combined by squaring, O(log multiplicity)
+RB_TREE_TEMPLATE
+RB_TREE::aggregate_type RB_TREE::lifted(node_ptr n) {
+  aggregate_type x = Monoid::lift(n->val_);
+  if constexpr (Counted) {
+    aggregate_type result = x;
+    for(size_t k = n->dups_; k != 0; k >>= 1) {
+      if(k & 1) {
+        result = Monoid::combine(result, x);
+      }
+      x = Monoid::combine(x, x);
+    }
+    return result;
+  }
+  return x;
+}
+
+RB_TREE_TEMPLATE
+RB_TREE::aggregate_type RB_TREE::subtree_aggregate(node_ptr n) {
+  if constexpr (has_monoid) {
+    return n == nullptr ? Monoid::identity() : n->aggregate_;
+  } else {
+    assert(0 && "subtree aggregates are kept only with Monoid");
+    return {};
+  }
+}
+
+// Recomputes augmented fields of n from its children
+RB_TREE_TEMPLATE
+void RB_TREE::update(node_ptr n) {
+  if constexpr (OrderStatistics) {
+    n->subtree_size_ = multiplicity(n) + subtree_size(n->left()) + subtree_size(n->right());
+  }
+  if constexpr (has_monoid) {
+    n->aggregate_ = Monoid::combine(Monoid::combine(subtree_aggregate(n->left()), lifted(n)),
+                                    subtree_aggregate(n->right()));
+  }
+}
 
-template<typename T>
-void rb_tree<T>::free(node* n) {
+RB_TREE_TEMPLATE
+void RB_TREE::update_to_root(node_ptr n) {
+  if constexpr (augmented) {
+    for(; n != nullptr; n = n->parent()) {
+      update(n);
+    }
+  }
+}
+
+RB_TREE_TEMPLATE
+void RB_TREE::free(node_ptr n) {
   if (n == nullptr) {
     return;
   }
@@ -505,7 +1227,10 @@ void rb_tree<T>::free(node* n) {
   free(n->left());
   free(n->right());
 
-  delete n;
+  node::destroy(n);
 }
 
-} // namespace rb
\ No newline at end of file
+} // namespace rb
+
+#undef RB_TREE
+#undef RB_TREE_TEMPLATE
\ No newline at end of file
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <utility>
+#include <vector>
+
+namespace rb {
+
+// Immutable sorted set in Eytzinger (BFS) layout: element k has children 2k
+// and 2k+1, so the top levels of every search share a few cache lines and the
+// next levels are prefetched while the current one is compared.
+// Built by rb_tree::freeze() in O(n), see "rb_tree.hpp".
+template<typename T, typename Compare = std::less<T>>
+class frozen_set {
+    using size_t = std::size_t;
+
+    // 1-based, data_[0] is unused
+    std::vector<T> data_;
+    size_t size_ = 0;
+    [[no_unique_address]] Compare comp_;
+
+    // children of k four levels below start at k * 16, prefetch that cache line
+    static constexpr size_t PrefetchLevels = 4;
+
+    void build(const std::vector<T>& sorted, size_t& i, size_t k) {
+      if(k > size_) {
+        return;
+      }
+      build(sorted, i, 2 * k);
+      data_[k] = sorted[i++];
+      build(sorted, i, 2 * k + 1);
+    }
+
+    void prefetch(size_t k) const {
+#if defined(__GNUC__)
+      // address may be past the end, prefetch doesn't fault
+      auto addr = reinterpret_cast<std::uintptr_t>(data_.data()) + (k << PrefetchLevels) * sizeof(T);
+      __builtin_prefetch(reinterpret_cast<const void*>(addr));
+#else
+      (void)k;
+#endif
+    }
+
+    // index of the first element >= val, 0 if there is none
+    size_t lower_bound_index(const T& val) const {
+      size_t k = 1;
+      while(k <= size_) {
+        prefetch(k);
+        k = 2 * k + comp_(data_[k], val);
+      }
+      // drop the trailing "went right" steps and the last "went left" one
+      return k >> (std::countr_one(k) + 1);
+    }
+
+  public:
+    frozen_set() : data_(1) {}
+
+    // sorted must be in ascending order (by comp)
+    explicit frozen_set(const std::vector<T>& sorted, const Compare& comp = Compare{})
+        : data_(sorted.size() + 1), size_(sorted.size()), comp_(comp) {
+      size_t i = 0;
+      build(sorted, i, 1);
+    }
+
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+
+    bool contains(const T& val) const {
+      size_t k = lower_bound_index(val);
+      return k != 0 && !comp_(val, data_[k]);
+    }
+
+    // first element not less than val, nullptr if there is none
+    const T* lower_bound(const T& val) const {
+      size_t k = lower_bound_index(val);
+      return k != 0 ? &data_[k] : nullptr;
+    }
+};
+
+} // namespace rb
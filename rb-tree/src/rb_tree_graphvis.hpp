@@ -2,32 +2,99 @@
 
 #include "rb_tree.hpp"
 
-template<typename T>
-void rb_tree<T>::node::to_graphvis(std::string& buf) {
-          buf += std::format("\t\tnode_{} [shape = Mrecord label = {}, fillcolor = {}, style=filled]\n", static_cast<void*>(this), val_, color_ ? "Red" : "Gray");
+// Value as a DOT record label: a quote would end the string, a backslash start
+// an escape, braces, bars and angle brackets would split the record
+inline std::string graphvis_escape(const std::string& label) {
+  std::string res;
+  res.reserve(label.size());
+  for(char c : label) {
+    switch(c) {
+    case '"': case '\\': case '{': case '}': case '|': case '<': case '>':
+      res += '\\';
+      break;
+    }
+    res += c;
+  }
+  return res;
+}
+
+RB_TREE_TEMPLATE
+void RB_TREE::node::to_graphvis(std::ostream& out) const {
+          std::string label = std::format("{}", val_);
+          if constexpr (Counted) {
+            if(dups_ != 0) {
+              label += std::format(" x{}", dups_ + 1);
+            }
+          }
+          out << std::format("\t\tnode_{} [shape = Mrecord label = \"{}\", fillcolor = {}, style=filled]\n", static_cast<const void*>(this), graphvis_escape(label), this->color() ? "Red" : "Gray");
         }
 
-template<typename T>
-void rb_tree<T>::to_graphvis(std::string &buf) {
-    buf += "digraph {\nrankdir = TB\n";
-    graphvis_traverse(root_, buf);
-    buf += "\n}\n";
+RB_TREE_TEMPLATE
+void RB_TREE::to_graphvis(std::string &buf) const {
+    std::ostringstream out;
+    to_graphvis(out);
+    buf += out.str();
 }
 
-template<typename T>
-void rb_tree<T>::graphvis_traverse(node* n, std::string &buf) {
-  if(n == nullptr) {
-    return;
+// Iterative preorder walk, every node is written once. Children beyond the
+// limits are replaced with one summary node per hidden subtree.
+RB_TREE_TEMPLATE
+void RB_TREE::to_graphvis(std::ostream &out, const graphvis_limits& limits) const {
+  out << "digraph {\nrankdir = TB\n";
+
+  std::vector<std::pair<node_ptr, size_t>> stack; // node and its depth
+  if(root_ != nullptr) {
+    stack.push_back({root_, 0});
   }
+  size_t emitted = 0;
+
+  while(!stack.empty()) {
+    auto [n, depth] = stack.back();
+    stack.pop_back();
+    n->to_graphvis(out);
+    emitted++;
 
-  n->to_graphvis(buf);
+    for(int dir : {node::Right, node::Left}) { // left child is popped first
+      node_ptr child = n->child(dir);
+      if(child == nullptr) {
+        continue;
+      }
 
-  for (int i = 0; i < 2; ++i) {
-    auto *child = n->children_[i];
-    if (child) {
-      child->to_graphvis(buf);
-      buf += std::format("\t\tnode_{} -> node_{}\n", static_cast<void*>(n), static_cast<void*>(child));
-      graphvis_traverse(child, buf);
+      if(depth + 1 > limits.max_depth || emitted + stack.size() >= limits.max_nodes) {
+        out << std::format("\t\tnode_{}_{} [shape = box label = \"... {} nodes\", style=dashed]\n",
+                           static_cast<const void*>(&*n), dir, count_nodes(child));
+        out << std::format("\t\tnode_{} -> node_{}_{}\n", static_cast<const void*>(&*n), static_cast<const void*>(&*n), dir);
+        continue;
+      }
+      out << std::format("\t\tnode_{} -> node_{}\n", static_cast<const void*>(&*n), static_cast<const void*>(&*child));
+      stack.push_back({child, depth + 1});
+    }
+  }
+
+  out << "\n}\n";
+}
+
+// subtree sizes count elements, with Counted a node can hold several
+RB_TREE_TEMPLATE
+RB_TREE::size_t RB_TREE::count_nodes(node_ptr n) {
+  if constexpr (OrderStatistics && !Counted) {
+    return subtree_size(n);
+  } else {
+    size_t cnt = 0;
+    std::vector<node_ptr> stack;
+    if(n != nullptr) {
+      stack.push_back(n);
+    }
+    while(!stack.empty()) {
+      node_ptr cur = stack.back();
+      stack.pop_back();
+      cnt++;
+      for(node_ptr child : {cur->left(), cur->right()}) {
+        if(child != nullptr) {
+          stack.push_back(child);
+        }
+      }
     }
+    return cnt;
   }
 }
@@ -0,0 +1,234 @@
+#pragma once
+
+#include "rb_tree.hpp"
+
+// rb_tree::save/load, value encoding is in "rb_tree_serializer.hpp"
+
+RB_TREE_TEMPLATE
+void RB_TREE::save(std::ostream& out) const {
+  io::header h{io::Magic, io::value_size<T>(), size_};
+  out.write(reinterpret_cast<const char*>(&h), sizeof(h));
+
+  if constexpr (std::is_trivially_copyable_v<T>) {
+    // copy into a buffer and write in bulk
+    constexpr size_t BufSize = 4096;
+    std::vector<T> buf;
+    buf.reserve(BufSize);
+    auto flush = [&] {
+      out.write(reinterpret_cast<const char*>(buf.data()), static_cast<std::streamsize>(buf.size() * sizeof(T)));
+      buf.clear();
+    };
+    for_each([&](const T& val) {
+      buf.push_back(val);
+      if(buf.size() == BufSize) {
+        flush();
+      }
+    });
+    flush();
+  } else {
+    for_each([&](const T& val) { serializer<T>::write(out, val); });
+  }
+
+  if(!out) {
+    throw std::runtime_error("rb_tree::save: write failed");
+  }
+}
+
+RB_TREE_TEMPLATE
+void RB_TREE::load(std::istream& in) {
+  io::header h{};
+  if(!in.read(reinterpret_cast<char*>(&h), sizeof(h))) {
+    throw std::runtime_error("rb_tree::load: truncated snapshot");
+  }
+  io::check_header<T>(h);
+
+  if constexpr (std::is_trivially_copyable_v<T>) {
+    constexpr size_t BufSize = 4096;
+    std::vector<T> buf(BufSize);
+    size_t pos = BufSize;
+    size_t left = h.count;
+    assign_sorted(h.count, [&]() -> T& {
+      if(pos == BufSize) {
+        size_t chunk = std::min(BufSize, left);
+        if(!in.read(reinterpret_cast<char*>(buf.data()), static_cast<std::streamsize>(chunk * sizeof(T)))) {
+          throw std::runtime_error("rb_tree::load: truncated snapshot");
+        }
+        left -= chunk;
+        pos = 0;
+      }
+      return buf[pos++];
+    });
+  } else {
+    T val;
+    assign_sorted(h.count, [&]() -> T& {
+      val = serializer<T>::read(in);
+      if(!in) {
+        throw std::runtime_error("rb_tree::load: truncated snapshot");
+      }
+      return val;
+    });
+  }
+}
+
+RB_TREE_TEMPLATE
+void RB_TREE::save_file(const std::string& path) const {
+  std::ofstream out(path, std::ios::binary);
+  if(!out) {
+    throw std::runtime_error("rb_tree::save_file: can't open " + path);
+  }
+  save(out);
+}
+
+RB_TREE_TEMPLATE
+void RB_TREE::load_file(const std::string& path) {
+#ifdef RB_TREE_HAS_MMAP
+  if constexpr (std::is_trivially_copyable_v<T>) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if(fd < 0) {
+      throw std::runtime_error("rb_tree::load_file: can't open " + path);
+    }
+    struct stat st{};
+    if(::fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(io::header)) {
+      ::close(fd);
+      throw std::runtime_error("rb_tree::load_file: truncated snapshot");
+    }
+    size_t file_size = st.st_size;
+    void* mapped = ::mmap(nullptr, file_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if(mapped == MAP_FAILED) {
+      throw std::runtime_error("rb_tree::load_file: mmap failed for " + path);
+    }
+    ::madvise(mapped, file_size, MADV_SEQUENTIAL);
+
+    struct unmap {
+        void* addr;
+        size_t size;
+        ~unmap() { ::munmap(addr, size); }
+    } guard{mapped, file_size};
+
+    io::header h;
+    std::memcpy(&h, mapped, sizeof(h));
+    io::check_header<T>(h);
+    if((file_size - sizeof(h)) / sizeof(T) < h.count) {
+      throw std::runtime_error("rb_tree::load_file: truncated snapshot");
+    }
+
+    // values may be unaligned in the mapping, copy each one out
+    const char* data = static_cast<const char*>(mapped) + sizeof(h);
+    T val;
+    assign_sorted(h.count, [&]() -> T& {
+      std::memcpy(&val, data, sizeof(T));
+      data += sizeof(T);
+      return val;
+    });
+    return;
+  }
+#endif
+  std::ifstream in(path, std::ios::binary);
+  if(!in) {
+    throw std::runtime_error("rb_tree::load_file: can't open " + path);
+  }
+  load(in);
+}
+
+// Replaces contents with count values produced by next() in ascending order.
+// The old tree is kept if next() throws or values are out of order.
+RB_TREE_TEMPLATE
+template<typename Next>
+void RB_TREE::assign_sorted(size_t count, Next&& next) {
+  // fill(n) sets values of the nodes in order
+  auto rebuild = [&](size_t nodes, auto& fill) {
+    // Midpoint splits keep all nulls within one level of each other.
+    // If the last level isn't full its nodes are red, all others are black.
+    size_t red_depth = SIZE_MAX;
+    if(nodes != 0 && ((nodes + 1) & nodes) != 0) {
+      red_depth = std::bit_width(nodes) - 1;
+    }
+
+    node_ptr root = build_sorted(nodes, 0, red_depth, fill);
+    if(root != nullptr) {
+      root->set_parent(nullptr);
+      root->set_color(node::Black);
+    }
+
+    free(root_);
+    root_ = root;
+    size_ = count;
+    finger_ = nullptr;
+    finger_next_ = nullptr;
+  };
+
+  if constexpr (Counted) {
+    // runs of equivalent values become one node, their number is known only at the end
+    std::vector<T> vals;
+    vals.reserve(std::min<size_t>(count, size_t{1} << 20)); // count isn't trusted yet
+    std::vector<size_t> runs; // index of the first value of every run
+    for(size_t i = 0; i < count; i++) {
+      vals.push_back(std::move(next()));
+      if(i != 0 && less(vals[i], vals[i - 1])) {
+        throw std::runtime_error("rb_tree::load: values are not sorted");
+      }
+      if(i == 0 || less(vals[i - 1], vals[i])) {
+        runs.push_back(i);
+      }
+    }
+    runs.push_back(count);
+
+    size_t run = 0;
+    auto fill = [&](node_ptr n) {
+      n->val_ = std::move(vals[runs[run]]);
+      n->dups_ = runs[run + 1] - runs[run] - 1;
+      run++;
+    };
+    rebuild(runs.size() - 1, fill);
+  } else {
+    bool has_prev = false;
+    node_ptr prev = nullptr;
+    auto checked_next = [&](node_ptr n) {
+      n->val_ = std::move(next());
+      if(has_prev && less(n->val_, prev->val_)) {
+        throw std::runtime_error("rb_tree::load: values are not sorted");
+      }
+      has_prev = true;
+      prev = n;
+    };
+    rebuild(count, checked_next);
+  }
+}
+
+// Builds a subtree from the next count values in order, frees it if next() throws
+RB_TREE_TEMPLATE
+template<typename Next>
+RB_TREE::node_ptr RB_TREE::build_sorted(size_t count, size_t depth, size_t red_depth, Next& next) {
+  if(count == 0) {
+    return nullptr;
+  }
+
+  size_t left_count = (count - 1) / 2;
+  node_ptr left = build_sorted(left_count, depth + 1, red_depth, next);
+  node_ptr n = nullptr;
+  node_ptr right = nullptr;
+  try {
+    n = node::create();
+    next(n);
+    right = build_sorted(count - 1 - left_count, depth + 1, red_depth, next);
+  } catch(...) {
+    free(left);
+    if(n != nullptr) {
+      node::destroy(n);
+    }
+    throw;
+  }
+
+  n->set_child(node::Left, left);
+  n->set_child(node::Right, right);
+  if(left != nullptr) {
+    left->set_parent(n);
+  }
+  if(right != nullptr) {
+    right->set_parent(n);
+  }
+  n->set_color(depth == red_depth ? node::Red : node::Black);
+  update(n);
+  return n;
+}
@@ -0,0 +1,183 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+#include <cassert>
+
+// Storage of links between rb_tree nodes (parent, children and color).
+// Node derives from node_links<Node, Layout> and the tree works only through
+// node_links::pointer and the accessors below, so layouts are interchangeable.
+
+namespace rb {
+
+enum class node_layout {
+    pointers,     // parent and children pointers and a separate color field
+    packed_color, // color lives in the lowest bit of the parent pointer
+    index32,      // 32-bit indices into a per-type node pool instead of pointers
+};
+
+template<typename Node, node_layout Layout>
+class node_links;
+
+template<typename Node>
+class node_links<Node, node_layout::pointers> {
+    Node *parent_;
+    Node *children_[2];
+    bool color_;
+
+  public:
+    using pointer = Node*;
+
+    pointer parent() const { return parent_; }
+    void set_parent(pointer p) { parent_ = p; }
+
+    pointer child(int dir) const { return children_[dir]; }
+    void set_child(int dir, pointer c) { children_[dir] = c; }
+
+    bool color() const { return color_; }
+    void set_color(bool c) { color_ = c; }
+
+    // Node constructed from args, value-initialized without them
+    template<typename... Args>
+    static pointer create(Args&&... args) { return new Node(std::forward<Args>(args)...); }
+    static void destroy(pointer n) { delete n; }
+};
+
+template<typename Node>
+class node_links<Node, node_layout::packed_color> {
+    static constexpr std::uintptr_t ColorBit = 1;
+
+    std::uintptr_t parent_and_color_;
+    Node *children_[2];
+
+  public:
+    using pointer = Node*;
+
+    pointer parent() const { return reinterpret_cast<Node*>(parent_and_color_ & ~ColorBit); }
+    void set_parent(pointer p) {
+      parent_and_color_ = reinterpret_cast<std::uintptr_t>(p) | (parent_and_color_ & ColorBit);
+    }
+
+    pointer child(int dir) const { return children_[dir]; }
+    void set_child(int dir, pointer c) { children_[dir] = c; }
+
+    bool color() const { return parent_and_color_ & ColorBit; }
+    void set_color(bool c) { parent_and_color_ = (parent_and_color_ & ~ColorBit) | (c ? ColorBit : 0); }
+
+    template<typename... Args>
+    static pointer create(Args&&... args) {
+      static_assert(alignof(Node) > ColorBit, "lowest pointer bit must be free");
+      return new Node(std::forward<Args>(args)...);
+    }
+    static void destroy(pointer n) { delete n; }
+};
+
+// Chunked pool shared by all nodes of one type, index 0 is nullptr.
+// Chunks never move, so index -> address is two loads and doesn't need a lock.
+template<typename Node>
+class node_pool {
+    static constexpr unsigned ChunkBits = 16;
+    static constexpr std::uint32_t ChunkSize = std::uint32_t{1} << ChunkBits;
+    static constexpr std::uint32_t MaxIndex = (std::uint32_t{1} << 31) - 1; // top bit is used for color
+    static constexpr std::uint32_t MaxChunks = (MaxIndex >> ChunkBits) + 1;
+
+    inline static std::atomic<Node*> chunks_[MaxChunks];
+    inline static std::mutex mutex_;
+    inline static std::uint32_t next_ = 1;
+    inline static std::vector<std::uint32_t> free_;
+
+  public:
+    static Node* at(std::uint32_t idx) {
+      return chunks_[idx >> ChunkBits].load(std::memory_order_acquire) + (idx & (ChunkSize - 1));
+    }
+
+    static std::uint32_t allocate() {
+      std::lock_guard lock{mutex_};
+      if(!free_.empty()) {
+        std::uint32_t idx = free_.back();
+        free_.pop_back();
+        return idx;
+      }
+
+      if(next_ > MaxIndex) {
+        throw std::bad_alloc();
+      }
+      std::uint32_t idx = next_++;
+      auto &chunk = chunks_[idx >> ChunkBits];
+      if(chunk.load(std::memory_order_relaxed) == nullptr) {
+        chunk.store(new Node[ChunkSize]{}, std::memory_order_release);
+      }
+      return idx;
+    }
+
+    static void release(std::uint32_t idx) {
+      assert(idx != 0);
+      *at(idx) = Node{}; // drop resources held by the value
+      std::lock_guard lock{mutex_};
+      free_.push_back(idx);
+    }
+};
+
+template<typename Node>
+class node_links<Node, node_layout::index32> {
+    static constexpr std::uint32_t ColorBit = std::uint32_t{1} << 31;
+
+    std::uint32_t parent_and_color_;
+    std::uint32_t children_[2];
+
+  public:
+    // index that behaves like Node*
+    class pointer {
+        std::uint32_t idx_ = 0;
+
+      public:
+        pointer() {}
+        pointer(std::nullptr_t) {}
+        explicit pointer(std::uint32_t idx) : idx_(idx) {}
+
+        std::uint32_t index() const { return idx_; }
+
+        Node* operator->() const { return node_pool<Node>::at(idx_); }
+        Node& operator*() const { return *node_pool<Node>::at(idx_); }
+        explicit operator bool() const { return idx_ != 0; }
+
+        bool operator==(const pointer&) const = default;
+        bool operator==(std::nullptr_t) const { return idx_ == 0; }
+    };
+
+    pointer parent() const { return pointer{parent_and_color_ & ~ColorBit}; }
+    void set_parent(pointer p) { parent_and_color_ = p.index() | (parent_and_color_ & ColorBit); }
+
+    pointer child(int dir) const { return pointer{children_[dir]}; }
+    void set_child(int dir, pointer c) { children_[dir] = c.index(); }
+
+    bool color() const { return parent_and_color_ & ColorBit; }
+    void set_color(bool c) { parent_and_color_ = (parent_and_color_ & ~ColorBit) | (c ? ColorBit : 0); }
+
+    // pool slots hold value-initialized nodes, with args the slot is rebuilt in place
+    template<typename... Args>
+    static pointer create(Args&&... args) {
+      pointer n{node_pool<Node>::allocate()};
+      if constexpr (sizeof...(Args) != 0) {
+        Node *slot = node_pool<Node>::at(n.index());
+        std::destroy_at(slot);
+        try {
+          std::construct_at(slot, std::forward<Args>(args)...);
+        } catch(...) {
+          std::construct_at(slot);
+          node_pool<Node>::release(n.index());
+          throw;
+        }
+      }
+      return n;
+    }
+    static void destroy(pointer n) { node_pool<Node>::release(n.index()); }
+};
+
+} // namespace rb
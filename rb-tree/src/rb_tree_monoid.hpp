@@ -0,0 +1,43 @@
+#pragma once
+
+#include <algorithm>
+#include <limits>
+
+// Monoids for rb_tree<T, OrderStatistics, Monoid>.
+// Monoid must provide:
+//   value_type
+//   static value_type identity();
+//   static value_type lift(const T&);                          - value of a single key
+//   static value_type combine(const value_type&, const value_type&); - associative
+// combine() is applied in key order, so it doesn't have to be commutative.
+
+namespace rb {
+
+template<typename T, typename Acc = T>
+struct sum_monoid {
+    using value_type = Acc;
+
+    static value_type identity() { return Acc{}; }
+    static value_type lift(const T& val) { return static_cast<Acc>(val); }
+    static value_type combine(const value_type& a, const value_type& b) { return a + b; }
+};
+
+template<typename T>
+struct min_monoid {
+    using value_type = T;
+
+    static value_type identity() { return std::numeric_limits<T>::max(); }
+    static value_type lift(const T& val) { return val; }
+    static value_type combine(const value_type& a, const value_type& b) { return std::min(a, b); }
+};
+
+template<typename T>
+struct max_monoid {
+    using value_type = T;
+
+    static value_type identity() { return std::numeric_limits<T>::lowest(); }
+    static value_type lift(const T& val) { return val; }
+    static value_type combine(const value_type& a, const value_type& b) { return std::max(a, b); }
+};
+
+} // namespace rb
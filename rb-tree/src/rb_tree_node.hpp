@@ -1,21 +1,34 @@
 #pragma once
 
-template<typename T>
-struct rb_tree<T>::node{
+// parent, children and color are kept by node_links, see "rb_tree_layout.hpp"
+RB_TREE_TEMPLATE
+struct RB_TREE::node : node_links<node, Layout> {
+    using links = node_links<node, Layout>;
+
     T val_;
-    node *parent_;
 
     enum {
         Black = false,
         Red = true
     };
-    bool color_; // true = red, false = black
 
     enum {
         Left = 0,
         Right = 1
     };
-    node *children_[2];
+
+    // number of nodes in subtree (only with OrderStatistics)
+    [[no_unique_address]] std::conditional_t<OrderStatistics, size_t, empty_field<0>> subtree_size_;
+    // Monoid aggregate of subtree (only with Monoid)
+    [[no_unique_address]] aggregate_type aggregate_;
+    // number of extra elements equivalent to val_ (only with Counted)
+    [[no_unique_address]] std::conditional_t<Counted, size_t, empty_field<2>> dups_;
+
+    node() = default;
+    // value constructed in place from args, links and fields zeroed as by node{}
+    template<typename... Args>
+    explicit node(std::in_place_t, Args&&... args)
+      : links(), val_(std::forward<Args>(args)...), subtree_size_(), aggregate_(), dups_() {}
 
     static_assert(1 - Right == Left);
     static_assert(1 - Left  == Right);
@@ -23,22 +36,27 @@ struct rb_tree<T>::node{
         assert(dir == Left || dir == Right);
         return 1 - dir;
     }
-        
-    void to_graphvis(std::string&);
 
-    node*& left() {
-        return children_[Left];
+    void to_graphvis(std::ostream&) const;
+
+    node_ptr left() const {
+        return links::child(Left);
     }
 
-    node*& right() {
-        return children_[Right];
+    node_ptr right() const {
+        return links::child(Right);
+    }
+
+    node_ptr child(int dir) const {
+        assert(dir == Left || dir == Right);
+        return links::child(dir);
     }
 
-    node*& child(int dir) {
+    void set_child(int dir, node_ptr n) {
         assert(dir == Left || dir == Right);
-        return children_[dir];
+        links::set_child(dir, n);
     }
 
-    static bool is_black(node* n) { return n == nullptr || n->color_ == node::Black; }
-    static bool is_red  (node* n) { return n != nullptr && n->color_ == node::Red; }
-};
\ No newline at end of file
+    static bool is_black(node_ptr n) { return n == nullptr || n->color() == node::Black; }
+    static bool is_red  (node_ptr n) { return n != nullptr && n->color() == node::Red; }
+};
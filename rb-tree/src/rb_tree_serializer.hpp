@@ -0,0 +1,95 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#if __has_include(<sys/mman.h>)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define RB_TREE_HAS_MMAP 1
+#endif
+
+// Serialization of rb_tree values, used by rb_tree::save/load (see "rb_tree_io.hpp").
+// Snapshot format (native byte order, not portable between architectures):
+//   u32 magic, u32 value size (sizeof(T) for trivially copyable T, 0 otherwise),
+//   u64 count, values in ascending order
+
+namespace rb {
+
+// How a single value is written, specialize for other types
+template<typename T>
+struct serializer {
+    static_assert(std::is_trivially_copyable_v<T>, "rb_tree::save: specialize rb::serializer for this type");
+
+    static void write(std::ostream& out, const T& val) {
+      out.write(reinterpret_cast<const char*>(&val), sizeof(T));
+    }
+    static T read(std::istream& in) {
+      T val;
+      in.read(reinterpret_cast<char*>(&val), sizeof(T));
+      return val;
+    }
+};
+
+template<>
+struct serializer<std::string> {
+    static void write(std::ostream& out, const std::string& val) {
+      std::uint64_t len = val.size();
+      out.write(reinterpret_cast<const char*>(&len), sizeof(len));
+      out.write(val.data(), static_cast<std::streamsize>(len));
+    }
+    // len isn't trusted: the string grows by chunks as the data arrives, so a
+    // malformed length ends in a failed stream (a truncated snapshot) instead
+    // of a huge allocation
+    static std::string read(std::istream& in) {
+      constexpr std::uint64_t Chunk = std::uint64_t{1} << 20;
+      std::uint64_t len = 0;
+      in.read(reinterpret_cast<char*>(&len), sizeof(len));
+      std::string val;
+      while(in && val.size() < len) {
+        std::size_t start = val.size();
+        val.resize(start + std::min(Chunk, len - start));
+        in.read(val.data() + start, static_cast<std::streamsize>(val.size() - start));
+      }
+      return val;
+    }
+};
+
+namespace io {
+
+constexpr std::uint32_t Magic = 0x31544252; // "RBT1"
+
+struct header {
+    std::uint32_t magic;
+    std::uint32_t value_size;
+    std::uint64_t count;
+};
+
+template<typename T>
+constexpr std::uint32_t value_size() {
+  return std::is_trivially_copyable_v<T> ? sizeof(T) : 0;
+}
+
+template<typename T>
+void check_header(const header& h) {
+  if(h.magic != Magic) {
+    throw std::runtime_error("rb_tree::load: not an rb_tree snapshot");
+  }
+  if(h.value_size != value_size<T>()) {
+    throw std::runtime_error("rb_tree::load: snapshot has different value type");
+  }
+}
+
+} // namespace io
+} // namespace rb
@@ -0,0 +1,76 @@
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include "batch.hpp"
+
+namespace {
+
+struct batch_result {
+    int code;
+    std::string out, err;
+};
+
+batch_result replay(const std::string& trace, const batch_options& opts = {}) {
+    std::istringstream in(trace);
+    testing::internal::CaptureStdout();
+    testing::internal::CaptureStderr();
+    int code = run_batch(in, opts);
+    std::string out = testing::internal::GetCapturedStdout();
+    return {code, out, testing::internal::GetCapturedStderr()};
+}
+
+// first line of the report: "tree sizes: <1st> <2nd>, hits: <hits>"
+std::string summary(const batch_result& res) {
+    return res.out.substr(0, res.out.find('\n'));
+}
+
+} // namespace
+
+TEST(Batch, operations) {
+    auto res = replay("i 5\ni 3\ni 9\nf 3\nf 4\nd 3\nd 3\nr 0 10\nr -5 4\n");
+    EXPECT_EQ(res.code, 0);
+    // found 3, deleted 3 once, 2 elements in [0, 10], none in [-5, 4]
+    EXPECT_EQ(summary(res), "tree sizes: 2 0, hits: 4");
+    EXPECT_NE(res.out.find("insert"), std::string::npos);
+    EXPECT_NE(res.out.find("range"), std::string::npos);
+    EXPECT_EQ(res.out.find("merge"), std::string::npos); // ops that didn't run aren't reported
+    EXPECT_TRUE(res.err.empty());
+}
+
+TEST(Batch, switch_and_merge) {
+    EXPECT_EQ(summary(replay("i 1\ns\ni 2\ni 3\n")), "tree sizes: 1 2, hits: 0");
+    // merge drops the duplicate 1 and continues on the 1st tree
+    EXPECT_EQ(summary(replay("i 1\ns\ni 1\ni 2\nm\ni 4\nf 2\n")), "tree sizes: 3 0, hits: 1");
+}
+
+TEST(Batch, comments_blank_lines_and_quit) {
+    auto res = replay("# header\n\n  i 7  \r\n\t# indented\ni 8\nq\ni 9\nthis is never read\n");
+    EXPECT_EQ(res.code, 0);
+    EXPECT_EQ(summary(res), "tree sizes: 2 0, hits: 0");
+}
+
+TEST(Batch, malformed_lines) {
+    for (std::string bad : {"x 1", "i", "i abc", "i 1 2", "r 1", "r 1 x", "s 3", "d 99999999999"}) {
+        auto res = replay("i 1\n" + bad + "\ni 2\n");
+        EXPECT_EQ(res.code, 1) << bad;
+        EXPECT_NE(res.err.find("line 2"), std::string::npos) << bad;
+        EXPECT_TRUE(res.out.empty()) << bad;
+    }
+}
+
+TEST(Batch, dot_output) {
+    auto path = std::filesystem::temp_directory_path() / "rb-tree-batch-unit-tests.dot";
+    std::filesystem::remove(path);
+
+    ASSERT_EQ(replay("i 1\ni 2\ns\ni 3\n", {.dot_path = path.string()}).code, 0);
+    std::ifstream in(path);
+    std::stringstream dot;
+    dot << in.rdbuf();
+    EXPECT_NE(dot.str().find("digraph"), std::string::npos);
+    EXPECT_NE(dot.str().find("3"), std::string::npos); // the current tree is dumped
+
+    std::filesystem::remove(path);
+}
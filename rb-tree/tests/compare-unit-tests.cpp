@@ -0,0 +1,300 @@
+#include <gtest/gtest.h>
+#include <functional>
+#include <random>
+#include <set>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "rb_tree.hpp"
+
+using namespace rb;
+
+template<typename Compare>
+using str_tree = rb_tree<std::string, false, void, node_layout::pointers, Compare>;
+
+namespace {
+
+std::vector<int> inorder(const auto& t) {
+    std::vector<int> v;
+    t.for_each([&](int x) { v.push_back(x); });
+    return v;
+}
+
+// counts key copies made by the tree
+struct tracked {
+    int key = 0;
+    inline static int copies = 0;
+
+    tracked() {}
+    explicit tracked(int k) : key(k) {}
+    tracked(const tracked& other) : key(other.key) { copies++; }
+    tracked(tracked&&) = default;
+    tracked& operator=(const tracked& other) { key = other.key; copies++; return *this; }
+    tracked& operator=(tracked&&) = default;
+};
+
+struct tracked_less {
+    using is_transparent = void;
+    bool operator()(const tracked& a, const tracked& b) const { return a.key < b.key; }
+    bool operator()(const tracked& a, int b) const { return a.key < b; }
+    bool operator()(int a, const tracked& b) const { return a < b.key; }
+};
+
+// neither copyable nor movable, only emplace can put it into a tree
+struct pinned {
+    int key = 0;
+
+    explicit pinned(int k) : key(k) {}
+    pinned(const pinned&) = delete;
+    pinned& operator=(const pinned&) = delete;
+};
+
+struct pinned_less {
+    using is_transparent = void;
+    bool operator()(const pinned& a, const pinned& b) const { return a.key < b.key; }
+    bool operator()(const pinned& a, int b) const { return a.key < b; }
+    bool operator()(int a, const pinned& b) const { return a < b.key; }
+};
+
+// orders by the key only, the tag tells which tree an element came from
+struct first_less {
+    bool operator()(const std::pair<int, char>& a, const std::pair<int, char>& b) const { return a.first < b.first; }
+};
+
+} // namespace
+
+TEST(Compare, greater) {
+    rb_tree<int, false, void, node_layout::pointers, std::greater<int>> t = {3, 1, 4, 1, 5};
+
+    std::vector<int> res = {5, 4, 3, 1, 1};
+    EXPECT_EQ(inorder(t), res);
+    EXPECT_TRUE(t.contains(4));
+    EXPECT_FALSE(t.contains(2));
+    ASSERT_NE(t.lower_bound(2), nullptr);
+    EXPECT_EQ(*t.lower_bound(2), 1);
+
+    auto f = t.freeze();
+    EXPECT_TRUE(f.contains(4));
+    EXPECT_FALSE(f.contains(2));
+}
+
+TEST(Compare, greater_merge) {
+    rb_tree<int, true, void, node_layout::pointers, std::greater<int>> t1 = {1, 3, 5};
+    rb_tree<int, true, void, node_layout::pointers, std::greater<int>> t2 = {2, 4, 6};
+    t1.merge(std::move(t2));
+
+    EXPECT_EQ(t1.size(), 6);
+    EXPECT_EQ(t1.select(0), 6);
+    EXPECT_EQ(t1.rank(4), 2);
+}
+
+TEST(Compare, transparent_lookup) {
+    str_tree<std::less<>> t = {"apple", "banana", "cherry"};
+
+    std::string_view key = "banana";
+    EXPECT_TRUE(t.contains(key));
+    EXPECT_TRUE(t.contains("cherry"));
+    EXPECT_FALSE(t.contains("durian"));
+
+    ASSERT_NE(t.find(key), nullptr);
+    EXPECT_EQ(*t.find(key), "banana");
+    EXPECT_EQ(t.find("durian"), nullptr);
+
+    EXPECT_TRUE(t.remove(std::string_view{"apple"}));
+    EXPECT_FALSE(t.contains("apple"));
+    EXPECT_EQ(t.size(), 2);
+}
+
+TEST(Compare, lookup_does_not_copy) {
+    rb_tree<tracked, false, void, node_layout::pointers, tracked_less> t;
+    for (int i = 0; i < 100; ++i) {
+        t.emplace(i);
+    }
+
+    tracked::copies = 0;
+    for (int i = 0; i < 200; ++i) {
+        EXPECT_EQ(t.contains(i), i < 100);
+    }
+    EXPECT_EQ(t.find(42)->key, 42);
+    EXPECT_TRUE(t.remove(42));
+    EXPECT_EQ(tracked::copies, 0);
+}
+
+TEST(Compare, emplace) {
+    str_tree<std::less<>> t;
+    t.emplace(3, 'a');
+    t.emplace("bb");
+
+    EXPECT_TRUE(t.contains("aaa"));
+    EXPECT_TRUE(t.contains("bb"));
+    EXPECT_EQ(t.size(), 2);
+}
+
+TEST(Compare, emplace_constructs_in_node) {
+    rb_tree<pinned, false, void, node_layout::pointers, pinned_less> t;
+    for (int k : {3, 1, 3, 2, 3}) {
+        t.emplace(k);
+    }
+    EXPECT_EQ(t.size(), 5);
+    EXPECT_EQ(t.find(2)->key, 2);
+
+    rb_tree<tracked, false, void, node_layout::index32, tracked_less> pooled;
+    tracked::copies = 0;
+    for (int i = 0; i < 10; ++i) {
+        pooled.emplace(i);
+    }
+    EXPECT_EQ(tracked::copies, 0);
+    EXPECT_TRUE(pooled.contains(7));
+}
+
+TEST(Compare, count_with_duplicates) {
+    rb_tree<pinned, false, void, node_layout::pointers, pinned_less> t;
+    for (int k : {3, 1, 3, 2, 3}) {
+        t.emplace(k);
+    }
+    EXPECT_EQ(t.count(3), 3);
+    EXPECT_EQ(t.count(1), 1);
+    EXPECT_EQ(t.count(0), 0);
+    EXPECT_EQ(t.count(4), 0);
+
+    std::mt19937 gen(11);
+    rb_tree<int> r;
+    std::multiset<int> ref;
+    for (int i = 0; i < 3000; ++i) {
+        int v = static_cast<int>(gen() % 100);
+        r.insert(v);
+        ref.insert(v);
+    }
+    for (int v = -1; v <= 100; ++v) {
+        EXPECT_EQ(r.count(v), ref.count(v));
+    }
+}
+
+TEST(Compare, merge_keeps_own_elements) {
+    using tagged_tree = rb_tree<std::pair<int, char>, false, void, node_layout::pointers, first_less>;
+    tagged_tree t1 = {{1, 'a'}, {2, 'a'}, {3, 'a'}};
+    tagged_tree t2 = {{2, 'b'}, {3, 'b'}, {4, 'b'}};
+    t1.merge(std::move(t2));
+
+    std::vector<std::pair<int, char>> res;
+    t1.for_each([&](const auto& e) { res.push_back(e); });
+    EXPECT_EQ(res, (std::vector<std::pair<int, char>>{{1, 'a'}, {2, 'a'}, {3, 'a'}, {4, 'b'}}));
+    EXPECT_EQ(t1.size(), 4);
+}
+
+TEST(Compare, merge_keeps_own_nodes) {
+    rb_tree<int> a = {10, 20};
+    rb_tree<int> b = {20, 30};
+    const int* p = a.find(20);
+    auto pos = a.insert(a.finger(), 15);
+    a.merge(std::move(b));
+
+    EXPECT_EQ(a.find(20), p);
+    EXPECT_EQ(*p, 20);
+    EXPECT_EQ(*pos, 15);
+    a.insert(pos, 16);
+    std::vector<int> res;
+    a.for_each([&](int v) { res.push_back(v); });
+    EXPECT_EQ(res, (std::vector<int>{10, 15, 16, 20, 30}));
+}
+
+TEST(Compare, erase_removes_all_equivalent) {
+    rb_tree<int> t = {1, 2, 2, 2, 3};
+
+    EXPECT_EQ(t.erase(2), 3);
+    EXPECT_EQ(t.erase(2), 0);
+    EXPECT_EQ(t.size(), 2);
+    EXPECT_EQ(inorder(t), (std::vector<int>{1, 3}));
+}
+
+TEST(NodeHandle, extract_and_insert) {
+    rb_tree<int> t1 = {1, 2, 3, 4, 5};
+    rb_tree<int> t2 = {10, 20};
+
+    const int* addr = t1.find(3);
+    auto nh = t1.extract(3);
+    ASSERT_FALSE(nh.empty());
+    EXPECT_EQ(nh.value(), 3);
+    EXPECT_FALSE(t1.contains(3));
+    EXPECT_EQ(t1.size(), 4);
+
+    t2.insert(std::move(nh));
+    EXPECT_TRUE(nh.empty());
+    EXPECT_TRUE(t2.contains(3));
+    EXPECT_EQ(t2.size(), 3);
+    EXPECT_EQ(t2.find(3), addr); // same node, no reallocation
+    EXPECT_EQ(inorder(t2), (std::vector<int>{3, 10, 20}));
+}
+
+TEST(NodeHandle, change_value) {
+    rb_tree<int> t = {1, 2, 3};
+
+    auto nh = t.extract(1);
+    nh.value() = 7;
+    t.insert(std::move(nh));
+    EXPECT_EQ(inorder(t), (std::vector<int>{2, 3, 7}));
+}
+
+TEST(NodeHandle, missing_and_dropped) {
+    rb_tree<int> t = {1, 2, 3};
+
+    auto missing = t.extract(5);
+    EXPECT_TRUE(missing.empty());
+    t.insert(std::move(missing));
+    EXPECT_EQ(t.size(), 3);
+
+    {
+        auto dropped = t.extract(2); // node is freed with the handle
+    }
+    EXPECT_EQ(inorder(t), (std::vector<int>{1, 3}));
+}
+
+// removal relinks nodes, so values of other elements stay where they are
+TEST(Remove, keeps_other_nodes) {
+    rb_tree<int> t;
+    for (int i = 0; i < 64; ++i) {
+        t.insert(i);
+    }
+    std::vector<const int*> addr;
+    for (int i = 0; i < 64; ++i) {
+        addr.push_back(t.find(i));
+    }
+
+    for (int i = 0; i < 64; i += 2) {
+        EXPECT_TRUE(t.remove(i));
+    }
+    for (int i = 1; i < 64; i += 2) {
+        EXPECT_EQ(t.find(i), addr[i]);
+    }
+}
+
+TEST(Remove, random_against_multiset) {
+    std::mt19937 gen(5);
+    rb_tree<int, true, sum_monoid<int, long long>> t;
+    std::multiset<int> ref;
+
+    for (int i = 0; i < 4000; ++i) {
+        int v = static_cast<int>(gen() % 300);
+        if (gen() % 3 == 0) {
+            auto it = ref.find(v);
+            bool found = it != ref.end();
+            if (found) {
+                ref.erase(it);
+            }
+            EXPECT_EQ(t.remove(v), found);
+        } else {
+            t.insert(v);
+            ref.insert(v);
+        }
+    }
+
+    EXPECT_EQ(t.size(), ref.size());
+    EXPECT_EQ(t.count_range(0, 299), ref.size());
+    long long sum = 0;
+    for (int v : ref) {
+        sum += v;
+    }
+    EXPECT_EQ(t.aggregate(), sum);
+    EXPECT_EQ(inorder(t), std::vector<int>(ref.begin(), ref.end()));
+}
@@ -0,0 +1,85 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <random>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include "concurrent_rb_tree.hpp"
+
+using ctree = rb::concurrent_rb_tree<int>;
+
+TEST(Concurrent, basic) {
+    ctree t = {3, 1, 2};
+
+    EXPECT_EQ(t.size(), 3);
+    EXPECT_TRUE(t.contains(2));
+    EXPECT_FALSE(t.contains(4));
+    EXPECT_TRUE(t.remove(2));
+    EXPECT_FALSE(t.remove(2));
+    EXPECT_FALSE(t.contains(2));
+    EXPECT_EQ(t.size(), 2);
+}
+
+TEST(Concurrent, random_against_set) {
+    std::mt19937 gen(11);
+    ctree t;
+    std::set<int> ref;
+
+    for (int i = 0; i < 3000; ++i) {
+        int val = static_cast<int>(gen() % 500);
+        if (gen() % 2 == 0) {
+            EXPECT_EQ(t.remove(val), ref.erase(val) == 1);
+        } else if (!ref.contains(val)) {
+            t.insert(val);
+            ref.insert(val);
+        }
+    }
+
+    EXPECT_EQ(t.size(), ref.size());
+    for (int val = 0; val < 500; ++val) {
+        EXPECT_EQ(t.contains(val), ref.contains(val));
+    }
+}
+
+TEST(Concurrent, readers_and_writers) {
+    // keys < Stable are never removed, readers must always see them
+    constexpr int Stable = 256;
+    ctree t;
+    for (int i = 0; i < Stable; ++i) {
+        t.insert(i);
+    }
+
+    std::atomic<bool> done = false;
+    std::atomic<int> missed = 0;
+    std::vector<std::thread> threads;
+    for (int r = 0; r < 4; ++r) {
+        threads.emplace_back([&, r] {
+            std::mt19937 gen(r);
+            while (!done) {
+                if (!t.contains(static_cast<int>(gen() % Stable))) {
+                    missed++;
+                }
+            }
+        });
+    }
+    for (int w = 0; w < 2; ++w) {
+        threads.emplace_back([&, w] {
+            for (int i = 0; i < 2000; ++i) {
+                int val = Stable + w * 100000 + i;
+                t.insert(val);
+                t.remove(val);
+            }
+        });
+    }
+
+    threads[4].join();
+    threads[5].join();
+    done = true;
+    for (int r = 0; r < 4; ++r) {
+        threads[r].join();
+    }
+
+    EXPECT_EQ(missed, 0);
+    EXPECT_EQ(t.size(), Stable);
+}
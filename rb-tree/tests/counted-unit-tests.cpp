@@ -0,0 +1,188 @@
+#include <gtest/gtest.h>
+#include <random>
+#include <set>
+#include <sstream>
+#include <vector>
+
+#include "rb_tree.hpp"
+#include "tree-checks.hpp"
+
+using namespace rb;
+
+namespace {
+
+using counted = rb_tree<int, false, void, node_layout::pointers, std::less<int>, true>;
+using counted_stats = rb_tree<int, true, sum_monoid<int, long long>, node_layout::pointers, std::less<int>, true>;
+
+template<typename Tree>
+std::vector<int> inorder(const Tree& t) {
+    std::vector<int> v;
+    t.for_each([&](int x) { v.push_back(x); });
+    return v;
+}
+
+} // namespace
+
+TEST(Counted, duplicates_share_node) {
+    counted t;
+    for(int i = 0; i < 5; i++) {
+        t.insert(7);
+    }
+    t.insert(3);
+
+    EXPECT_EQ(t.size(), 6);
+    EXPECT_EQ(t.get_preorder().size(), 2);
+    EXPECT_EQ(t.count(7), 5);
+    EXPECT_EQ(t.count(3), 1);
+    EXPECT_EQ(t.count(4), 0);
+    EXPECT_EQ(inorder(t), (std::vector<int>{3, 7, 7, 7, 7, 7}));
+    EXPECT_TRUE(checks::is_valid(t));
+}
+
+TEST(Counted, remove_decrements) {
+    counted t{4, 4, 4, 9};
+
+    EXPECT_TRUE(t.remove(4));
+    EXPECT_EQ(t.count(4), 2);
+    EXPECT_EQ(t.size(), 3);
+    EXPECT_EQ(t.get_preorder().size(), 2);
+
+    EXPECT_EQ(t.erase(4), 2);
+    EXPECT_FALSE(t.contains(4));
+    EXPECT_FALSE(t.remove(4));
+    EXPECT_EQ(t.size(), 1);
+    EXPECT_TRUE(checks::is_valid(t));
+}
+
+TEST(Counted, matches_multiset) {
+    std::mt19937 gen(39);
+    std::uniform_int_distribution<int> key(0, 200);
+    counted_stats t;
+    std::multiset<int> ref;
+
+    for(int i = 0; i < 20000; i++) {
+        int k = key(gen);
+        if(gen() % 3 == 0) {
+            auto it = ref.find(k);
+            EXPECT_EQ(t.remove(k), it != ref.end());
+            if(it != ref.end()) {
+                ref.erase(it);
+            }
+        } else {
+            t.insert(k);
+            ref.insert(k);
+        }
+    }
+
+    ASSERT_EQ(t.size(), ref.size());
+    EXPECT_EQ(inorder(t), std::vector<int>(ref.begin(), ref.end()));
+    EXPECT_TRUE(checks::is_valid(t));
+
+    std::vector<int> sorted(ref.begin(), ref.end());
+    for(size_t k = 0; k < sorted.size(); k += 37) {
+        EXPECT_EQ(t.select(k), sorted[k]);
+    }
+    for(int v = 0; v <= 200; v += 13) {
+        EXPECT_EQ(t.rank(v), static_cast<size_t>(std::distance(ref.begin(), ref.lower_bound(v))));
+        EXPECT_EQ(t.count(v), ref.count(v));
+    }
+    EXPECT_EQ(t.count_range(10, 50), static_cast<size_t>(std::distance(ref.lower_bound(10), ref.upper_bound(50))));
+
+    long long sum = 0;
+    for(int v : ref) {
+        if(v >= 10 && v <= 50) {
+            sum += v;
+        }
+    }
+    EXPECT_EQ(t.aggregate(10, 50), sum);
+}
+
+TEST(Counted, merge_adds_counts) {
+    counted a{1, 2, 2, 5};
+    counted b{2, 5, 5, 8};
+
+    a.merge(std::move(b));
+    EXPECT_EQ(a.size(), 8);
+    EXPECT_EQ(b.size(), 0);
+    EXPECT_EQ(a.count(2), 3);
+    EXPECT_EQ(a.count(5), 3);
+    EXPECT_EQ(inorder(a), (std::vector<int>{1, 2, 2, 2, 5, 5, 5, 8}));
+    EXPECT_EQ(a.get_preorder().size(), 4);
+    EXPECT_TRUE(checks::is_valid(a));
+}
+
+TEST(Counted, merge_keeps_order_statistics) {
+    counted_stats a;
+    counted_stats b;
+    for(int i = 0; i < 300; i++) {
+        a.insert(i % 50);
+        b.insert(i % 70);
+    }
+
+    a.merge(std::move(b));
+    EXPECT_EQ(a.size(), 600);
+    EXPECT_EQ(a.count_range(0, 69), 600);
+    EXPECT_EQ(a.rank(50), 300 + 220); // all of a, i % 70 < 50 for 220 values of i
+    EXPECT_TRUE(checks::is_valid(a));
+}
+
+TEST(Counted, hinted_insert) {
+    counted t;
+    counted::position pos;
+    for(int i = 0; i < 100; i++) {
+        pos = t.insert(pos, i / 4);
+    }
+    for(int i = 0; i < 25; i++) {
+        t.insert(t.insert(pos, i), i);
+    }
+
+    EXPECT_EQ(t.size(), 150);
+    EXPECT_EQ(t.get_preorder().size(), 25);
+    EXPECT_EQ(t.count(0), 6);
+    EXPECT_EQ(t.count(24), 6);
+    EXPECT_TRUE(checks::is_valid(t));
+}
+
+TEST(Counted, extract_takes_all_copies) {
+    counted a{3, 3, 3};
+    counted b{3};
+
+    auto nh = a.extract(3);
+    EXPECT_EQ(a.size(), 0);
+    b.insert(std::move(nh));
+    EXPECT_EQ(b.size(), 4);
+    EXPECT_EQ(b.count(3), 4);
+    EXPECT_EQ(b.get_preorder().size(), 1);
+}
+
+TEST(Counted, save_load_collapses_runs) {
+    counted t;
+    for(int i = 0; i < 1000; i++) {
+        t.insert(i % 10);
+    }
+
+    std::stringstream buf;
+    t.save(buf);
+    counted u;
+    u.load(buf);
+
+    EXPECT_EQ(u.size(), 1000);
+    EXPECT_EQ(u.get_preorder().size(), 10);
+    EXPECT_EQ(u.count(7), 100);
+    EXPECT_EQ(inorder(u), inorder(t));
+    EXPECT_TRUE(checks::is_valid(u));
+
+    // a plain tree reads the same snapshot as separate elements
+    std::stringstream again;
+    u.save(again);
+    rb_tree<int> plain;
+    plain.load(again);
+    EXPECT_EQ(plain.size(), 1000);
+    EXPECT_EQ(plain.count(7), 100);
+}
+
+TEST(Counted, plain_tree_count) {
+    rb_tree<int> t{1, 2, 2, 2, 3};
+    EXPECT_EQ(t.count(2), 3);
+    EXPECT_EQ(t.count(4), 0);
+}
@@ -0,0 +1,72 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "rb_tree.hpp"
+
+TEST(Frozen, empty) {
+    rb::rb_tree<int> t;
+    auto f = t.freeze();
+
+    EXPECT_TRUE(f.empty());
+    EXPECT_FALSE(f.contains(0));
+    EXPECT_EQ(f.lower_bound(0), nullptr);
+}
+
+TEST(Frozen, contains) {
+    rb::rb_tree<int> t = {10, 20, 30, 40, 50};
+    auto f = t.freeze();
+
+    EXPECT_EQ(f.size(), 5);
+    for (int v : {10, 20, 30, 40, 50}) {
+        EXPECT_TRUE(f.contains(v));
+    }
+    for (int v : {0, 15, 55}) {
+        EXPECT_FALSE(f.contains(v));
+    }
+}
+
+TEST(Frozen, lower_bound) {
+    rb::rb_tree<int> t = {10, 20, 30, 40, 50};
+    auto f = t.freeze();
+
+    ASSERT_NE(f.lower_bound(5), nullptr);
+    EXPECT_EQ(*f.lower_bound(5), 10);
+    EXPECT_EQ(*f.lower_bound(20), 20);
+    EXPECT_EQ(*f.lower_bound(21), 30);
+    EXPECT_EQ(f.lower_bound(51), nullptr);
+
+    EXPECT_EQ(*t.lower_bound(21), 30);
+    EXPECT_EQ(t.lower_bound(51), nullptr);
+}
+
+TEST(Frozen, unaffected_by_tree_updates) {
+    rb::rb_tree<int> t = {1, 2, 3};
+    auto f = t.freeze();
+    t.insert(4);
+    t.remove(1);
+
+    EXPECT_TRUE(f.contains(1));
+    EXPECT_FALSE(f.contains(4));
+}
+
+TEST(Frozen, random_against_tree) {
+    std::mt19937 gen(9);
+    rb::rb_tree<int> t;
+    for (int i = 0; i < 5000; ++i) {
+        t.insert(static_cast<int>(gen() % 20000));
+    }
+    auto f = t.freeze();
+
+    EXPECT_EQ(f.size(), t.size());
+    for (int v = -1; v <= 20001; ++v) {
+        EXPECT_EQ(f.contains(v), t.contains(v));
+        auto tree_lb = t.lower_bound(v);
+        auto frozen_lb = f.lower_bound(v);
+        ASSERT_EQ(tree_lb == nullptr, frozen_lb == nullptr);
+        if (tree_lb != nullptr) {
+            EXPECT_EQ(*tree_lb, *frozen_lb);
+        }
+    }
+}
@@ -0,0 +1,142 @@
+#include <gtest/gtest.h>
+#include <regex>
+#include <set>
+#include <sstream>
+#include <string>
+
+#include "rb_tree.hpp"
+
+using namespace rb;
+
+namespace {
+
+struct dot_stats {
+    std::multiset<std::string> nodes;  // ids of declared tree nodes
+    size_t summaries = 0;
+    size_t hidden = 0;                 // nodes behind summaries
+    size_t edges = 0;
+};
+
+dot_stats parse(const std::string& dot) {
+    dot_stats res;
+    std::istringstream in(dot);
+    std::string line;
+    std::regex node_re(R"(^\s*(node_\w+) \[shape = Mrecord)");
+    std::regex summary_re(R"(\[shape = box label = "\.\.\. (\d+) nodes")");
+    std::smatch m;
+    while (std::getline(in, line)) {
+        if (std::regex_search(line, m, node_re)) {
+            res.nodes.insert(m[1]);
+        } else if (std::regex_search(line, m, summary_re)) {
+            res.summaries++;
+            res.hidden += std::stoul(m[1]);
+        } else if (line.find("->") != std::string::npos) {
+            res.edges++;
+        }
+    }
+    return res;
+}
+
+template<typename Tree>
+dot_stats export_tree(const Tree& t, const graphvis_limits& limits = {}) {
+    std::ostringstream out;
+    t.to_graphvis(out, limits);
+    return parse(out.str());
+}
+
+bool all_unique(const std::multiset<std::string>& ids) {
+    return std::set<std::string>(ids.begin(), ids.end()).size() == ids.size();
+}
+
+} // namespace
+
+TEST(Graphvis, empty) {
+    rb_tree<int> t;
+    auto s = export_tree(t);
+    EXPECT_EQ(s.nodes.size(), 0);
+    EXPECT_EQ(s.edges, 0);
+}
+
+TEST(Graphvis, every_node_once) {
+    rb_tree<int> t;
+    for (int i = 0; i < 1000; ++i) {
+        t.insert(i);
+    }
+
+    auto s = export_tree(t);
+    EXPECT_EQ(s.nodes.size(), 1000);
+    EXPECT_TRUE(all_unique(s.nodes));
+    EXPECT_EQ(s.edges, 999);
+    EXPECT_EQ(s.summaries, 0);
+
+    std::string buf;
+    t.to_graphvis(buf);
+    auto from_string = parse(buf);
+    EXPECT_EQ(from_string.nodes, s.nodes);
+}
+
+TEST(Graphvis, depth_limit) {
+    rb_tree<int> t;
+    for (int i = 0; i < 1000; ++i) {
+        t.insert(i);
+    }
+
+    auto s = export_tree(t, {.max_depth = 2});
+    EXPECT_LE(s.nodes.size(), 7);
+    EXPECT_GT(s.summaries, 0);
+    EXPECT_EQ(s.nodes.size() + s.hidden, 1000);
+    EXPECT_EQ(s.edges, s.nodes.size() - 1 + s.summaries);
+}
+
+TEST(Graphvis, node_limit) {
+    rb_tree<int, true> t;
+    for (int i = 0; i < 5000; ++i) {
+        t.insert(i);
+    }
+
+    auto s = export_tree(t, {.max_nodes = 100});
+    EXPECT_LE(s.nodes.size(), 100);
+    EXPECT_TRUE(all_unique(s.nodes));
+    EXPECT_EQ(s.nodes.size() + s.hidden, 5000);
+}
+
+// with Counted a node holds several elements, summaries still count nodes
+TEST(Graphvis, counted_summaries_count_nodes) {
+    rb_tree<int, true, void, node_layout::pointers, std::less<int>, true> t;
+    for (int i = 0; i < 500; ++i) {
+        for (int k = 0; k < 3; ++k) {
+            t.insert(i);
+        }
+    }
+
+    auto s = export_tree(t, {.max_nodes = 50});
+    EXPECT_GT(s.summaries, 0);
+    EXPECT_EQ(s.nodes.size() + s.hidden, 500);
+}
+
+TEST(Graphvis, labels_are_escaped) {
+    rb_tree<std::string> t = {"say \"hi\"", "back\\slash", "{a|b}", "<port>"};
+
+    std::ostringstream out;
+    t.to_graphvis(out);
+    std::string dot = out.str();
+    EXPECT_NE(dot.find(R"(label = "say \"hi\"")"), std::string::npos);
+    EXPECT_NE(dot.find(R"(label = "back\\slash")"), std::string::npos);
+    EXPECT_NE(dot.find(R"(label = "\{a\|b\}")"), std::string::npos);
+    EXPECT_NE(dot.find(R"(label = "\<port\>")"), std::string::npos);
+
+    // every label is one string: quotes not preceded by a backslash come in pairs
+    std::istringstream in(dot);
+    std::string line;
+    while (std::getline(in, line)) {
+        size_t quotes = 0;
+        for (size_t i = 0; i < line.size(); ++i) {
+            if (line[i] == '\\') {
+                ++i;
+            } else if (line[i] == '"') {
+                quotes++;
+            }
+        }
+        EXPECT_EQ(quotes % 2, 0) << line;
+    }
+}
@@ -0,0 +1,118 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "rb_tree.hpp"
+#include "tree-checks.hpp"
+
+using namespace rb;
+
+namespace {
+
+template<typename Tree>
+std::vector<int> inorder(const Tree& t) {
+    std::vector<int> v;
+    t.for_each([&](int x) { v.push_back(x); });
+    return v;
+}
+
+} // namespace
+
+TEST(Hint, finger_follows_insertions) {
+    rb_tree<int> t;
+    EXPECT_TRUE(t.finger().empty());
+
+    t.insert(5);
+    EXPECT_EQ(*t.finger(), 5);
+    auto pos = t.insert(t.finger(), 7);
+    EXPECT_EQ(*pos, 7);
+    EXPECT_EQ(t.finger(), pos);
+
+    t.remove(5);
+    EXPECT_TRUE(t.finger().empty());
+}
+
+TEST(Hint, sorted_appends) {
+    rb_tree<int> t;
+    rb_tree<int>::position pos;
+    for (int i = 0; i < 2000; ++i) {
+        pos = t.insert(pos, i);
+    }
+
+    EXPECT_EQ(t.size(), 2000);
+    EXPECT_TRUE(checks::is_valid(t));
+    std::vector<int> res(2000);
+    std::iota(res.begin(), res.end(), 0);
+    EXPECT_EQ(inorder(t), res);
+}
+
+TEST(Hint, descending_and_near_sorted) {
+    rb_tree<int, true> t;
+    std::mt19937 gen(1);
+    std::vector<int> keys;
+    for (int i = 0; i < 1000; ++i) {
+        keys.push_back(3000 - 3 * i); // descending
+    }
+    for (int i = 0; i < 1000; ++i) {
+        keys.push_back(4000 + 3 * i + static_cast<int>(gen() % 2)); // near-sorted
+    }
+
+    for (int k : keys) {
+        t.insert({}, k);
+    }
+
+    std::sort(keys.begin(), keys.end());
+    EXPECT_TRUE(checks::is_valid(t));
+    EXPECT_EQ(inorder(t), keys);
+    EXPECT_EQ(t.select(1000), keys[1000]);
+}
+
+TEST(Hint, random_hints) {
+    std::mt19937 gen(7);
+    rb_tree<int, true> t;
+    std::vector<rb_tree<int, true>::position> positions;
+    std::vector<int> keys(3000);
+    std::iota(keys.begin(), keys.end(), 0);
+    std::shuffle(keys.begin(), keys.end(), gen);
+
+    for (int k : keys) {
+        rb_tree<int, true>::position hint;
+        if (!positions.empty()) {
+            hint = positions[gen() % positions.size()];
+        }
+        positions.push_back(t.insert(hint, k));
+        EXPECT_EQ(*positions.back(), k);
+    }
+
+    EXPECT_TRUE(checks::is_valid(t));
+    std::sort(keys.begin(), keys.end());
+    EXPECT_EQ(inorder(t), keys);
+    for (int i = 0; i < 3000; i += 100) {
+        EXPECT_EQ(t.rank(i), i);
+    }
+}
+
+TEST(Hint, mixed_with_removals) {
+    std::mt19937 gen(11);
+    rb_tree<int> t;
+    std::vector<int> ref;
+
+    for (int i = 0; i < 3000; ++i) {
+        int k = 2 * i + static_cast<int>(gen() % 7);
+        if (gen() % 5 == 0 && !ref.empty()) {
+            int victim = ref[gen() % ref.size()];
+            EXPECT_TRUE(t.remove(victim));
+            ref.erase(std::find(ref.begin(), ref.end(), victim));
+        } else if (std::find(ref.begin(), ref.end(), k) == ref.end()) {
+            t.insert(t.finger(), k);
+            ref.push_back(k);
+        }
+    }
+
+    EXPECT_TRUE(checks::is_valid(t));
+    std::sort(ref.begin(), ref.end());
+    EXPECT_EQ(inorder(t), ref);
+}
@@ -0,0 +1,160 @@
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <numeric>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "rb_tree.hpp"
+#include "tree-checks.hpp"
+
+using namespace rb;
+
+namespace {
+
+template<typename Tree>
+auto inorder(const Tree& t) {
+    std::vector<std::decay_t<decltype(*t.lower_bound({}))>> v;
+    t.for_each([&](const auto& x) { v.push_back(x); });
+    return v;
+}
+
+template<typename Tree>
+void roundtrip(const Tree& from, Tree& to) {
+    std::stringstream buf;
+    from.save(buf);
+    to.load(buf);
+}
+
+} // namespace
+
+TEST(IO, roundtrip_sizes) {
+    for (int n : {0, 1, 2, 3, 7, 8, 100, 1023, 1024, 1025}) {
+        rb_tree<int> t;
+        for (int i = 0; i < n; ++i) {
+            t.insert(i * 3);
+        }
+
+        rb_tree<int> loaded;
+        roundtrip(t, loaded);
+        EXPECT_EQ(loaded.size(), n);
+        EXPECT_TRUE(checks::is_valid(loaded)) << n;
+        EXPECT_EQ(inorder(loaded), inorder(t));
+    }
+}
+
+TEST(IO, load_replaces_contents) {
+    rb_tree<int> t = {1, 2, 3};
+    rb_tree<int> loaded = {10, 20};
+    roundtrip(t, loaded);
+
+    EXPECT_EQ(inorder(loaded), (std::vector<int>{1, 2, 3}));
+    loaded.insert(4);
+    EXPECT_TRUE(loaded.remove(1));
+    EXPECT_TRUE(checks::is_valid(loaded));
+}
+
+TEST(IO, strings) {
+    rb_tree<std::string> t = {"pear", "", "apple", std::string(1000, 'x')};
+
+    rb_tree<std::string> loaded;
+    roundtrip(t, loaded);
+    EXPECT_EQ(loaded.size(), 4);
+    EXPECT_EQ(inorder(loaded), inorder(t));
+}
+
+TEST(IO, augmented) {
+    rb_tree<int, true, sum_monoid<int, long long>, node_layout::index32> t;
+    for (int i = 0; i < 500; ++i) {
+        t.insert(i);
+    }
+
+    decltype(t) loaded;
+    roundtrip(t, loaded);
+    EXPECT_EQ(loaded.select(123), 123);
+    EXPECT_EQ(loaded.rank(400), 400);
+    EXPECT_EQ(loaded.aggregate(), 499LL * 500 / 2);
+}
+
+TEST(IO, malformed_input) {
+    rb_tree<int> t = {1, 2, 3};
+    std::stringstream buf;
+    t.save(buf);
+    std::string data = buf.str();
+
+    rb_tree<int> loaded = {42};
+    auto load = [&](const std::string& bytes) {
+        std::stringstream in(bytes);
+        loaded.load(in);
+    };
+
+    EXPECT_THROW(load(""), std::runtime_error);
+    EXPECT_THROW(load(data.substr(0, data.size() - 1)), std::runtime_error);
+
+    std::string bad_magic = data;
+    bad_magic[0] ^= 1;
+    EXPECT_THROW(load(bad_magic), std::runtime_error);
+
+    rb_tree<double> other;
+    EXPECT_THROW({
+        std::stringstream in(data);
+        other.load(in);
+    }, std::runtime_error);
+
+    // swap last two values
+    std::string unsorted = data;
+    std::swap_ranges(unsorted.end() - 8, unsorted.end() - 4, unsorted.end() - 4);
+    EXPECT_THROW(load(unsorted), std::runtime_error);
+
+    // failed loads keep the tree
+    EXPECT_EQ(inorder(loaded), std::vector<int>{42});
+}
+
+TEST(IO, malformed_string_lengths) {
+    rb_tree<std::string> t = {"a", "bb", std::string((3 << 20) + 5, 'x')}; // longer than a read chunk
+    std::stringstream buf;
+    t.save(buf);
+    std::string data = buf.str();
+
+    rb_tree<std::string> copy;
+    std::stringstream in(data);
+    copy.load(in);
+    EXPECT_EQ(inorder(copy), inorder(t));
+
+    rb_tree<std::string> loaded = {"keep"};
+    auto load = [&](const std::string& bytes) {
+        std::stringstream in(bytes);
+        loaded.load(in);
+    };
+
+    // length of the first string follows the 16 byte header
+    for (std::uint64_t len : {std::uint64_t{1} << 62, ~std::uint64_t{0}, std::uint64_t{data.size()}}) {
+        std::string corrupt = data;
+        std::memcpy(corrupt.data() + 16, &len, sizeof(len));
+        EXPECT_THROW(load(corrupt), std::runtime_error) << len;
+    }
+    EXPECT_THROW(load(data.substr(0, data.size() - 1)), std::runtime_error);
+    EXPECT_EQ(inorder(loaded), std::vector<std::string>{"keep"});
+}
+
+TEST(IO, file_roundtrip) {
+    auto path = (std::filesystem::temp_directory_path() / "rb-tree-io-test.bin").string();
+    std::mt19937 gen(3);
+    rb_tree<long long> t;
+    for (int i = 0; i < 10000; ++i) {
+        t.insert(static_cast<long long>(gen()));
+    }
+
+    t.save_file(path);
+    rb_tree<long long> loaded;
+    loaded.load_file(path);
+    std::filesystem::remove(path);
+
+    EXPECT_EQ(loaded.size(), t.size());
+    EXPECT_EQ(inorder(loaded), inorder(t));
+    EXPECT_THROW(loaded.load_file(path), std::runtime_error);
+}
@@ -0,0 +1,93 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "rb_tree.hpp"
+
+using rb::node_layout;
+
+template<node_layout Layout>
+using int_tree = rb::rb_tree<int, false, void, Layout>;
+
+template<node_layout Layout>
+using double_tree = rb::rb_tree<double, false, void, Layout>;
+
+template<node_layout Layout>
+using augmented_tree = rb::rb_tree<int, true, rb::sum_monoid<int, long long>, Layout>;
+
+TEST(Layout, node_size) {
+    EXPECT_EQ(double_tree<node_layout::pointers>::node_size(), 40);
+    EXPECT_EQ(double_tree<node_layout::packed_color>::node_size(), 32);
+    EXPECT_EQ(double_tree<node_layout::index32>::node_size(), 24);
+
+    EXPECT_LE(int_tree<node_layout::packed_color>::node_size(), int_tree<node_layout::pointers>::node_size());
+    EXPECT_EQ(int_tree<node_layout::index32>::node_size(), 16);
+}
+
+template<typename Tree>
+class LayoutTyped : public ::testing::Test {};
+
+using layouts = ::testing::Types<augmented_tree<node_layout::pointers>,
+                                 augmented_tree<node_layout::packed_color>,
+                                 augmented_tree<node_layout::index32>>;
+TYPED_TEST_SUITE(LayoutTyped, layouts);
+
+TYPED_TEST(LayoutTyped, random_against_sorted_vector) {
+    std::mt19937 gen(5);
+    std::uniform_int_distribution<int> dist(0, 2000);
+
+    TypeParam t;
+    std::vector<int> ref;
+    for (int i = 0; i < 3000; ++i) {
+        int val = dist(gen);
+        if (gen() % 3 == 0) {
+            if (t.remove(val)) {
+                ref.erase(std::find(ref.begin(), ref.end(), val));
+            }
+        } else {
+            t.insert(val);
+            ref.push_back(val);
+        }
+    }
+    std::sort(ref.begin(), ref.end());
+
+    ASSERT_EQ(t.size(), ref.size());
+    for (size_t k = 0; k < ref.size(); k += 17) {
+        EXPECT_EQ(t.select(k), ref[k]);
+    }
+    long long sum = 0;
+    for (int v : ref) {
+        sum += v;
+    }
+    EXPECT_EQ(t.aggregate(), sum);
+}
+
+TYPED_TEST(LayoutTyped, merge) {
+    TypeParam t1;
+    TypeParam t2;
+    for (int i = 0; i < 100; ++i) {
+        t1.insert(i * 2);
+        t2.insert(i * 2 + 1);
+    }
+
+    t1.merge(std::move(t2));
+
+    EXPECT_EQ(t1.size(), 200);
+    EXPECT_EQ(t1.aggregate(), 199 * 200 / 2);
+    for (int i = 0; i < 200; ++i) {
+        EXPECT_EQ(t1.select(i), i);
+    }
+}
+
+TEST(Layout, index32_non_trivial_values) {
+    rb::rb_tree<std::string, false, void, node_layout::index32> t;
+    for (int i = 0; i < 100; ++i) {
+        t.insert(std::string(50, static_cast<char>('a' + i % 26)) + std::to_string(i));
+    }
+    for (int i = 0; i < 100; i += 2) {
+        EXPECT_TRUE(t.remove(std::string(50, static_cast<char>('a' + i % 26)) + std::to_string(i)));
+    }
+    EXPECT_EQ(t.size(), 50);
+}
@@ -0,0 +1,141 @@
+#include <gtest/gtest.h>
+#include <map>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "rb_map.hpp"
+
+using namespace rb;
+
+using int_map = rb_map<int, std::string>;
+
+namespace {
+
+template<typename Map>
+std::vector<std::pair<int, std::string>> entries(const Map& m) {
+    std::vector<std::pair<int, std::string>> v;
+    m.for_each([&](int k, const std::string& val) { v.emplace_back(k, val); });
+    return v;
+}
+
+} // namespace
+
+TEST(Map, empty) {
+    int_map m;
+    EXPECT_TRUE(m.empty());
+    EXPECT_EQ(m.find(1), nullptr);
+    EXPECT_FALSE(m.contains(1));
+    EXPECT_FALSE(m.remove(1));
+}
+
+TEST(Map, try_emplace) {
+    int_map m;
+
+    auto [v, inserted] = m.try_emplace(1, 3, 'a');
+    EXPECT_TRUE(inserted);
+    EXPECT_EQ(*v, "aaa");
+
+    auto [v2, inserted2] = m.try_emplace(1, "other");
+    EXPECT_FALSE(inserted2);
+    EXPECT_EQ(v2, v);
+    EXPECT_EQ(*v2, "aaa");
+    EXPECT_EQ(m.size(), 1);
+}
+
+TEST(Map, subscript) {
+    int_map m;
+    m[2] = "two";
+    m[1] = "one";
+    m[2] += "!";
+
+    EXPECT_EQ(m.size(), 2);
+    EXPECT_EQ(*m.find(2), "two!");
+    EXPECT_EQ(m[3], "");
+    EXPECT_EQ(m.size(), 3);
+}
+
+TEST(Map, insert_or_assign) {
+    int_map m;
+    EXPECT_TRUE(m.insert_or_assign(5, "a"));
+    EXPECT_FALSE(m.insert_or_assign(5, "b"));
+
+    EXPECT_EQ(m.size(), 1);
+    EXPECT_EQ(*m.find(5), "b");
+}
+
+TEST(Map, ordered_traversal) {
+    int_map m = {{3, "c"}, {1, "a"}, {2, "b"}};
+
+    std::vector<std::pair<int, std::string>> res = {{1, "a"}, {2, "b"}, {3, "c"}};
+    EXPECT_EQ(entries(m), res);
+
+    m.for_each([](int, std::string& val) { val += val; });
+    EXPECT_EQ(*m.find(2), "bb");
+}
+
+TEST(Map, merge_keeps_own_values) {
+    int_map m1 = {{1, "a"}, {2, "b"}};
+    int_map m2 = {{2, "B"}, {3, "C"}};
+
+    m1.merge(std::move(m2));
+
+    std::vector<std::pair<int, std::string>> res = {{1, "a"}, {2, "b"}, {3, "C"}};
+    EXPECT_EQ(entries(m1), res);
+    EXPECT_EQ(m1.size(), 3);
+    EXPECT_TRUE(m2.empty());
+}
+
+TEST(Map, merge_with_resolver) {
+    rb_map<int, int> m1;
+    rb_map<int, int> m2;
+    for (int i = 0; i < 100; ++i) {
+        m1[i] = 1;
+    }
+    for (int i = 50; i < 150; ++i) {
+        m2[i] = 10;
+    }
+
+    int conflicts = 0;
+    m1.merge(std::move(m2), [&](const int&, int mine, int theirs) {
+        conflicts++;
+        return mine + theirs;
+    });
+
+    EXPECT_EQ(conflicts, 50);
+    EXPECT_EQ(m1.size(), 150);
+    EXPECT_EQ(*m1.find(10), 1);
+    EXPECT_EQ(*m1.find(75), 11);
+    EXPECT_EQ(*m1.find(120), 10);
+}
+
+TEST(Map, random_against_std_map) {
+    std::mt19937 gen(3);
+    rb_map<int, int> m;
+    std::map<int, int> ref;
+
+    for (int i = 0; i < 5000; ++i) {
+        int k = static_cast<int>(gen() % 500);
+        switch (gen() % 4) {
+            case 0:
+                EXPECT_EQ(m.remove(k), ref.erase(k) == 1);
+                break;
+            case 1:
+                EXPECT_EQ(m.insert_or_assign(k, i), ref.insert_or_assign(k, i).second);
+                break;
+            case 2:
+                EXPECT_EQ(m.try_emplace(k, i).second, ref.try_emplace(k, i).second);
+                break;
+            default:
+                m[k]++;
+                ref[k]++;
+                break;
+        }
+    }
+
+    EXPECT_EQ(m.size(), ref.size());
+    std::vector<std::pair<int, int>> got;
+    m.for_each([&](int k, int v) { got.emplace_back(k, v); });
+    EXPECT_EQ(got, (std::vector<std::pair<int, int>>(ref.begin(), ref.end())));
+}
@@ -0,0 +1,131 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include "rb_tree.hpp"
+
+using sum_tree = rb::rb_tree<int, false, rb::sum_monoid<int, long long>>;
+using min_tree = rb::rb_tree<int, false, rb::min_monoid<int>>;
+using max_tree = rb::rb_tree<int, true, rb::max_monoid<int>>;
+
+// Not commutative: checks that elements are combined in key order
+struct concat_monoid {
+    using value_type = std::vector<int>;
+
+    static value_type identity() { return {}; }
+    static value_type lift(const int& val) { return {val}; }
+    static value_type combine(const value_type& a, const value_type& b) {
+        value_type res = a;
+        res.insert(res.end(), b.begin(), b.end());
+        return res;
+    }
+};
+
+using concat_tree = rb::rb_tree<int, false, concat_monoid>;
+
+TEST(Monoid, empty) {
+    sum_tree t;
+    EXPECT_EQ(t.aggregate(), 0);
+    EXPECT_EQ(t.aggregate(0, 100), 0);
+}
+
+TEST(Monoid, sum) {
+    sum_tree t = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
+
+    EXPECT_EQ(t.aggregate(), 55);
+    EXPECT_EQ(t.aggregate(3, 7), 25);
+    EXPECT_EQ(t.aggregate(-5, 2), 3);
+    EXPECT_EQ(t.aggregate(10, 20), 10);
+    EXPECT_EQ(t.aggregate(11, 20), 0);
+    EXPECT_EQ(t.aggregate(7, 3), 0);
+}
+
+TEST(Monoid, min) {
+    min_tree t = {40, 10, 30, 20, 50};
+
+    EXPECT_EQ(t.aggregate(), 10);
+    EXPECT_EQ(t.aggregate(15, 45), 20);
+    EXPECT_EQ(t.aggregate(51, 60), std::numeric_limits<int>::max());
+}
+
+TEST(Monoid, max_with_order_statistics) {
+    max_tree t = {40, 10, 30, 20, 50};
+
+    EXPECT_EQ(t.aggregate(15, 45), 40);
+    EXPECT_EQ(t.count_range(15, 45), 3);
+    EXPECT_EQ(t.select(1), 20);
+}
+
+TEST(Monoid, key_order) {
+    concat_tree t = {5, 3, 9, 1, 7, 2, 8};
+
+    std::vector<int> all = {1, 2, 3, 5, 7, 8, 9};
+    std::vector<int> part = {3, 5, 7};
+    EXPECT_EQ(t.aggregate(), all);
+    EXPECT_EQ(t.aggregate(3, 7), part);
+}
+
+TEST(Monoid, after_remove) {
+    sum_tree t;
+    for (int i = 1; i <= 100; ++i) {
+        t.insert(i);
+    }
+    for (int i = 2; i <= 100; i += 2) {
+        EXPECT_TRUE(t.remove(i));
+    }
+
+    EXPECT_EQ(t.aggregate(), 2500);
+    EXPECT_EQ(t.aggregate(1, 10), 25);
+}
+
+TEST(Monoid, after_merge) {
+    concat_tree t1;
+    concat_tree t2;
+    std::vector<int> all;
+    for (int i = 0; i < 50; ++i) {
+        t1.insert(i * 2);
+        t2.insert(i * 2 + 1);
+        all.push_back(i * 2);
+        all.push_back(i * 2 + 1);
+    }
+    std::sort(all.begin(), all.end());
+
+    t1.merge(std::move(t2));
+
+    EXPECT_EQ(t1.aggregate(), all);
+    std::vector<int> part(all.begin() + 10, all.begin() + 21);
+    EXPECT_EQ(t1.aggregate(10, 20), part);
+}
+
+TEST(Monoid, random_against_scan) {
+    std::mt19937 gen(7);
+    std::uniform_int_distribution<int> dist(0, 1000);
+
+    sum_tree t;
+    std::vector<int> ref;
+    for (int i = 0; i < 3000; ++i) {
+        int val = dist(gen);
+        if (gen() % 3 == 0) {
+            if (t.remove(val)) {
+                ref.erase(std::find(ref.begin(), ref.end(), val));
+            }
+        } else {
+            t.insert(val);
+            ref.push_back(val);
+        }
+    }
+
+    for (int i = 0; i < 200; ++i) {
+        int lo = dist(gen);
+        int hi = lo + dist(gen) / 4;
+        long long expected = 0;
+        for (int v : ref) {
+            if (lo <= v && v <= hi) {
+                expected += v;
+            }
+        }
+        EXPECT_EQ(t.aggregate(lo, hi), expected);
+    }
+}
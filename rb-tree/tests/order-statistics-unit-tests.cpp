@@ -0,0 +1,118 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include "rb_tree.hpp"
+
+using os_tree = rb::rb_tree<int, true>;
+
+TEST(OrderStatistics, empty) {
+    os_tree t;
+    EXPECT_EQ(t.rank(42), 0);
+    EXPECT_EQ(t.count_range(0, 100), 0);
+    EXPECT_THROW(t.select(0), std::out_of_range);
+}
+
+TEST(OrderStatistics, select) {
+    os_tree t = {50, 10, 40, 20, 30};
+
+    EXPECT_EQ(t.select(0), 10);
+    EXPECT_EQ(t.select(2), 30);
+    EXPECT_EQ(t.select(4), 50);
+    EXPECT_THROW(t.select(5), std::out_of_range);
+}
+
+TEST(OrderStatistics, rank) {
+    os_tree t = {50, 10, 40, 20, 30};
+
+    EXPECT_EQ(t.rank(10), 0);
+    EXPECT_EQ(t.rank(35), 3);
+    EXPECT_EQ(t.rank(50), 4);
+    EXPECT_EQ(t.rank(100), 5);
+}
+
+TEST(OrderStatistics, count_range) {
+    os_tree t = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
+
+    EXPECT_EQ(t.count_range(3, 7), 5);
+    EXPECT_EQ(t.count_range(0, 100), 10);
+    EXPECT_EQ(t.count_range(5, 5), 1);
+    EXPECT_EQ(t.count_range(7, 3), 0);
+}
+
+TEST(OrderStatistics, duplicates) {
+    os_tree t = {5, 5, 5, 1, 9};
+
+    EXPECT_EQ(t.rank(5), 1);
+    EXPECT_EQ(t.count_range(5, 5), 3);
+    EXPECT_EQ(t.select(3), 5);
+    EXPECT_EQ(t.select(4), 9);
+}
+
+TEST(OrderStatistics, after_remove) {
+    os_tree t;
+    for (int i = 0; i < 100; ++i) {
+        t.insert(i);
+    }
+    for (int i = 0; i < 100; i += 2) {
+        EXPECT_TRUE(t.remove(i));
+    }
+
+    EXPECT_EQ(t.size(), 50);
+    for (int i = 0; i < 50; ++i) {
+        EXPECT_EQ(t.select(i), 2 * i + 1);
+    }
+    EXPECT_EQ(t.count_range(10, 20), 5);
+}
+
+TEST(OrderStatistics, after_merge) {
+    os_tree t1;
+    os_tree t2;
+    for (int i = 0; i < 50; ++i) {
+        t1.insert(i * 2);
+        t2.insert(i * 2 + 1);
+    }
+
+    t1.merge(std::move(t2));
+
+    EXPECT_EQ(t1.size(), 100);
+    for (int i = 0; i < 100; ++i) {
+        EXPECT_EQ(t1.select(i), i);
+        EXPECT_EQ(t1.rank(i), i);
+    }
+}
+
+TEST(OrderStatistics, random_against_sorted_vector) {
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<int> dist(0, 500);
+
+    os_tree t;
+    std::vector<int> ref;
+    for (int i = 0; i < 2000; ++i) {
+        int val = dist(gen);
+        if (gen() % 3 == 0) {
+            if (t.remove(val)) {
+                auto it = std::find(ref.begin(), ref.end(), val);
+                ASSERT_NE(it, ref.end());
+                ref.erase(it);
+            }
+        } else {
+            t.insert(val);
+            ref.push_back(val);
+        }
+    }
+    std::sort(ref.begin(), ref.end());
+
+    ASSERT_EQ(t.size(), ref.size());
+    for (size_t k = 0; k < ref.size(); ++k) {
+        EXPECT_EQ(t.select(k), ref[k]);
+    }
+    for (int val = -1; val <= 501; val += 7) {
+        auto lower = std::lower_bound(ref.begin(), ref.end(), val) - ref.begin();
+        auto upper = std::upper_bound(ref.begin(), ref.end(), val + 50) - ref.begin();
+        EXPECT_EQ(t.rank(val), lower);
+        EXPECT_EQ(t.count_range(val, val + 50), upper - lower);
+    }
+}
@@ -0,0 +1,156 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <atomic>
+#include <random>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include "persistent_rb_tree.hpp"
+#include "tree-checks.hpp"
+
+using ptree = rb::persistent_rb_tree<int>;
+
+namespace {
+
+std::vector<int> to_vector(const ptree::version& v) {
+    std::vector<int> res;
+    v.for_each([&](int val) { res.push_back(val); });
+    return res;
+}
+
+} // namespace
+
+TEST(Persistent, empty) {
+    ptree t;
+    EXPECT_EQ(t.size(), 0);
+    EXPECT_FALSE(t.contains(42));
+    EXPECT_FALSE(t.remove(42));
+    EXPECT_TRUE(t.snapshot().empty());
+}
+
+TEST(Persistent, insert) {
+    ptree t = {1, 2, 3, 4, 5};
+
+    EXPECT_EQ(t.size(), 5);
+    for (int i = 1; i <= 5; ++i) {
+        EXPECT_TRUE(t.contains(i));
+    }
+    EXPECT_FALSE(t.contains(6));
+    EXPECT_TRUE(checks::is_valid(t.snapshot()));
+}
+
+TEST(Persistent, remove) {
+    ptree t = {1, 2, 3, 4, 5, 6, 7};
+
+    EXPECT_TRUE(t.remove(4));
+    EXPECT_FALSE(t.remove(4));
+    EXPECT_EQ(t.size(), 6);
+    EXPECT_FALSE(t.contains(4));
+    EXPECT_TRUE(checks::is_valid(t.snapshot()));
+}
+
+TEST(Persistent, duplicates) {
+    ptree t = {5, 5, 5};
+
+    EXPECT_EQ(t.size(), 3);
+    EXPECT_TRUE(t.remove(5));
+    EXPECT_TRUE(t.remove(5));
+    EXPECT_TRUE(t.contains(5));
+    EXPECT_TRUE(t.remove(5));
+    EXPECT_FALSE(t.contains(5));
+}
+
+TEST(Persistent, snapshot_is_immutable) {
+    ptree t = {10, 20, 30};
+    auto before = t.snapshot();
+
+    t.insert(15);
+    t.remove(20);
+    auto after = t.snapshot();
+
+    std::vector<int> before_res = {10, 20, 30};
+    std::vector<int> after_res = {10, 15, 30};
+    EXPECT_EQ(to_vector(before), before_res);
+    EXPECT_EQ(before.size(), 3);
+    EXPECT_EQ(to_vector(after), after_res);
+    EXPECT_EQ(after.size(), 3);
+}
+
+TEST(Persistent, snapshot_outlives_tree) {
+    ptree::version v;
+    {
+        ptree t = {1, 2, 3};
+        v = t.snapshot();
+    }
+    std::vector<int> res = {1, 2, 3};
+    EXPECT_EQ(to_vector(v), res);
+}
+
+TEST(Persistent, random_against_set) {
+    std::mt19937 gen(3);
+    ptree t;
+    std::set<int> ref;
+    std::vector<ptree::version> versions;
+    std::vector<std::set<int>> ref_versions;
+
+    for (int i = 0; i < 3000; ++i) {
+        int val = static_cast<int>(gen() % 1000);
+        if (gen() % 3 == 0) {
+            EXPECT_EQ(t.remove(val), ref.erase(val) == 1);
+        } else if (!ref.contains(val)) {
+            t.insert(val);
+            ref.insert(val);
+        }
+        if (i % 300 == 0) {
+            versions.push_back(t.snapshot());
+            ref_versions.push_back(ref);
+        }
+    }
+
+    EXPECT_TRUE(checks::is_valid(t.snapshot()));
+    EXPECT_EQ(to_vector(t.snapshot()), std::vector<int>(ref.begin(), ref.end()));
+    for (size_t i = 0; i < versions.size(); ++i) {
+        EXPECT_TRUE(checks::is_valid(versions[i]));
+        EXPECT_EQ(to_vector(versions[i]), std::vector<int>(ref_versions[i].begin(), ref_versions[i].end()));
+    }
+}
+
+TEST(Persistent, concurrent_readers) {
+    ptree t;
+    std::atomic<bool> done = false;
+
+    std::vector<std::thread> readers;
+    std::atomic<int> bad_snapshots = 0;
+    for (int r = 0; r < 3; ++r) {
+        readers.emplace_back([&] {
+            while (!done) {
+                auto v = t.snapshot();
+                auto elems = to_vector(v);
+                // writer only inserts 0..n-1 in order
+                if (elems.size() != v.size() ||
+                    (!elems.empty() && elems.back() != static_cast<int>(elems.size()) - 1)) {
+                    bad_snapshots++;
+                }
+                // writer inserts 0 first and removes only from the top
+                if (t.size() != 0 && !t.contains(0)) {
+                    bad_snapshots++;
+                }
+            }
+        });
+    }
+
+    for (int i = 0; i < 2000; ++i) {
+        t.insert(i);
+    }
+    for (int i = 0; i < 1000; ++i) {
+        t.remove(1999 - i);
+    }
+    done = true;
+    for (auto& r : readers) {
+        r.join();
+    }
+
+    EXPECT_EQ(bad_snapshots, 0);
+    EXPECT_EQ(t.size(), 1000);
+}
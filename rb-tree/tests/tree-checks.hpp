@@ -0,0 +1,37 @@
+#pragma once
+
+#include <utility>
+#include <vector>
+
+// Checks shared by the tests
+
+namespace checks {
+
+// Rebuilds the tree from its preorder (keys must be distinct) and checks the
+// search tree order and red-black properties. Returns black height, -1 if broken.
+inline int check_subtree(const std::vector<std::pair<int, bool>>& pre, size_t& i, long long lo, long long hi, bool parent_red) {
+    if (i == pre.size() || pre[i].first < lo || pre[i].first > hi) {
+        return 1;
+    }
+    auto [val, red] = pre[i++];
+    if (red && parent_red) {
+        return -1;
+    }
+    int left = check_subtree(pre, i, lo, val - 1LL, red);
+    int right = check_subtree(pre, i, val + 1LL, hi, red);
+    if (left < 0 || left != right) {
+        return -1;
+    }
+    return left + (red ? 0 : 1);
+}
+
+// Tree is anything with get_preorder(): rb_tree or a persistent_rb_tree version
+template<typename Tree>
+bool is_valid(Tree&& t) {
+    auto pre = t.get_preorder();
+    size_t i = 0;
+    bool ok = check_subtree(pre, i, -(1LL << 40), 1LL << 40, false) > 0 && i == pre.size();
+    return ok && (pre.empty() || !pre[0].second);
+}
+
+} // namespace checks